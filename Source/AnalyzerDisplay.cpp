@@ -0,0 +1,89 @@
+#include "AnalyzerDisplay.h"
+
+// displayed level and frequency ranges
+static const float minDecibels = -96.0f;
+static const float minFrequency = 20.0f;
+static const float maxFrequency = 20000.0f;
+
+AnalyzerDisplay::AnalyzerDisplay(ConekoAudioProcessor &processor)
+    : audioProcessor(processor),
+      analyzer(processor.getDryAnalyzerFifo(), processor.getWetAnalyzerFifo(),
+               processor.getAnalyzerActiveFlag()) {
+  analyzer.getFrame(frame);
+  setOpaque(true);
+  startTimerHz(SignalAnalyzer::frameRate);
+}
+
+AnalyzerDisplay::~AnalyzerDisplay() { stopTimer(); }
+
+void AnalyzerDisplay::timerCallback() {
+  analyzer.getFrame(frame);
+  repaint();
+}
+
+void AnalyzerDisplay::paint(juce::Graphics &g) {
+  g.fillAll(juce::Colour::fromRGB(252, 248, 237));
+  const double sampleRate = audioProcessor.getSampleRate();
+  if (sampleRate <= 0.0) {
+    return;
+  }
+
+  auto bounds = getLocalBounds().toFloat();
+  auto spectrumBounds = bounds.removeFromLeft(bounds.getWidth() * 2 / 3);
+  auto historyBounds = bounds.withTrimmedLeft(10.0f);
+
+  // spectra on a logarithmic frequency axis
+  auto levelToY = [](float level, juce::Rectangle<float> area) {
+    return juce::jmap(juce::jmax(level, minDecibels), minDecibels, 0.0f,
+                      area.getBottom(), area.getY());
+  };
+  auto makeSpectrumPath = [&](juce::Path &path,
+                              const std::array<float, SignalAnalyzer::numBins>
+                                  &spectrum) {
+    path.clear();
+    bool isFirstPoint = true;
+    for (int bin = 1; bin < SignalAnalyzer::numBins; ++bin) {
+      const float frequency =
+          static_cast<float>(bin * sampleRate / SignalAnalyzer::fftSize);
+      if (frequency < minFrequency || frequency > maxFrequency) {
+        continue;
+      }
+      const float x =
+          spectrumBounds.getX() +
+          spectrumBounds.getWidth() * std::log(frequency / minFrequency) /
+              std::log(maxFrequency / minFrequency);
+      const float y = levelToY(spectrum[bin], spectrumBounds);
+      if (isFirstPoint) {
+        path.startNewSubPath(x, y);
+        isFirstPoint = false;
+      } else {
+        path.lineTo(x, y);
+      }
+    }
+  };
+  makeSpectrumPath(dryPath, frame.drySpectrum);
+  makeSpectrumPath(wetPath, frame.wetSpectrum);
+  g.setColour(juce::Colour::fromRGB(222, 186, 157));
+  g.strokePath(dryPath, juce::PathStrokeType(1.0f));
+  g.setColour(juce::Colour::fromRGB(158, 119, 119));
+  g.strokePath(wetPath, juce::PathStrokeType(1.0f));
+
+  // wet level history, the tail shows as the slope after the input stops
+  historyPath.clear();
+  historyPath.startNewSubPath(historyBounds.getBottomLeft());
+  for (int index = 0; index < SignalAnalyzer::historySize; ++index) {
+    const float x = historyBounds.getX() +
+                    historyBounds.getWidth() * index /
+                        (SignalAnalyzer::historySize - 1);
+    historyPath.lineTo(x,
+                       levelToY(frame.wetLevelHistory[index], historyBounds));
+  }
+  historyPath.lineTo(historyBounds.getBottomRight());
+  historyPath.closeSubPath();
+  g.setColour(juce::Colour::fromRGB(158, 119, 119).withAlpha(0.5f));
+  g.fillPath(historyPath);
+
+  g.setColour(juce::Colour::fromRGB(111, 76, 91));
+  g.drawRect(spectrumBounds, 1.0f);
+  g.drawRect(historyBounds, 1.0f);
+}
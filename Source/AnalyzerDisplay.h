@@ -0,0 +1,29 @@
+#pragma once
+
+#include "PluginProcessor.h"
+#include "SignalAnalyzer.h"
+#include <JuceHeader.h>
+
+// Shows the dry and wet spectra next to a scrolling history of the wet level,
+// which makes the reverb tail visible. Owns the analyzer, so analysis runs
+// only while the editor is open.
+class AnalyzerDisplay : public juce::Component, private juce::Timer {
+public:
+  AnalyzerDisplay(ConekoAudioProcessor &processor);
+  ~AnalyzerDisplay() override;
+
+  void paint(juce::Graphics &) override;
+
+private:
+  void timerCallback() override;
+
+  ConekoAudioProcessor &audioProcessor;
+  SignalAnalyzer analyzer;
+  SignalAnalyzer::Frame frame;
+
+  juce::Path dryPath;
+  juce::Path wetPath;
+  juce::Path historyPath;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(AnalyzerDisplay)
+};
@@ -0,0 +1,153 @@
+#include "Equalizer.h"
+
+bool Equalizer::Band::isActive() const {
+  return g.isSmoothing() || a.isSmoothing() || a.getTargetValue() != 1.0f;
+}
+
+void Equalizer::Band::updateCoefficients(float newG, float newA) {
+  // a peak's damping follows its gain to keep the bandwidth symmetric
+  const float k = type == BandType::peak ? damping / newA : damping;
+  a1 = 1.0f / (1.0f + newG * (newG + k));
+  a2 = newG * a1;
+  a3 = newG * a2;
+  switch (type) {
+  case BandType::lowShelf:
+    m0 = 1.0f;
+    m1 = k * (newA - 1.0f);
+    m2 = newA * newA - 1.0f;
+    break;
+  case BandType::highShelf:
+    m0 = newA * newA;
+    m1 = k * (1.0f - newA) * newA;
+    m2 = 1.0f - newA * newA;
+    break;
+  case BandType::peak:
+    m0 = 1.0f;
+    m1 = k * (newA * newA - 1.0f);
+    m2 = 0.0f;
+    break;
+  }
+}
+
+Equalizer::Lanes Equalizer::Band::processSample(Lanes v0) {
+  const Lanes v3 = v0 - ic2eq;
+  const Lanes v1 = ic1eq * a1 + v3 * a2;
+  const Lanes v2 = ic2eq + ic1eq * a2 + v3 * a3;
+  ic1eq = v1 * 2.0f - ic1eq;
+  ic2eq = v2 * 2.0f - ic2eq;
+  return v0 * m0 + v1 * m1 + v2 * m2;
+}
+
+Equalizer::Equalizer(std::initializer_list<BandType> bandTypes) {
+  jassert(bandTypes.size() <= maxBands);
+  for (auto bandType : bandTypes) {
+    if (numBands < maxBands) {
+      bands[numBands++].type = bandType;
+    }
+  }
+}
+
+void Equalizer::prepare(const juce::dsp::ProcessSpec &spec) {
+  jassert(spec.numChannels <= Lanes::size());
+  sampleRate = spec.sampleRate;
+  for (int band = 0; band < numBands; ++band) {
+    bands[band].g.reset(sampleRate, ParameterRamp::rampTime);
+    bands[band].a.reset(sampleRate, ParameterRamp::rampTime);
+    bands[band].hasParameters = false;
+  }
+  isPrepared = true;
+  reset();
+}
+
+void Equalizer::reset() {
+  for (auto &band : bands) {
+    band.ic1eq = Lanes::expand(0.0f);
+    band.ic2eq = Lanes::expand(0.0f);
+  }
+}
+
+void Equalizer::setBandParameters(int bandIndex, float frequency,
+                                  float gainDecibels, float quality) {
+  jassert(bandIndex >= 0 && bandIndex < numBands);
+  auto &band = bands[bandIndex];
+  if (!isPrepared ||
+      (band.hasParameters && frequency == band.frequency &&
+       gainDecibels == band.gainDecibels && quality == band.quality)) {
+    return;
+  }
+  band.frequency = frequency;
+  band.gainDecibels = gainDecibels;
+  band.quality = quality;
+  band.damping = 1.0f / quality;
+
+  const double nyquistLimit = sampleRate * 0.49;
+  const double g = std::tan(juce::MathConstants<double>::pi *
+                            juce::jmin<double>(frequency, nyquistLimit) /
+                            sampleRate);
+  const double a = std::pow(10.0, gainDecibels / 40.0);
+  // shelves are offset by their gain so that the frequency marks the
+  // midpoint of the transition
+  double shiftedG = g;
+  if (band.type == BandType::lowShelf) {
+    shiftedG = g / std::sqrt(a);
+  } else if (band.type == BandType::highShelf) {
+    shiftedG = g * std::sqrt(a);
+  }
+
+  if (!band.hasParameters) {
+    band.g.setCurrentAndTargetValue(static_cast<float>(shiftedG));
+    band.a.setCurrentAndTargetValue(static_cast<float>(a));
+    band.hasParameters = true;
+  } else {
+    band.g.setTargetValue(static_cast<float>(shiftedG));
+    band.a.setTargetValue(static_cast<float>(a));
+  }
+  band.updateCoefficients(band.g.getCurrentValue(), band.a.getCurrentValue());
+}
+
+void Equalizer::process(
+    const juce::dsp::ProcessContextReplacing<float> &context) {
+  auto &block = context.getOutputBlock();
+  const int numSamples = static_cast<int>(block.getNumSamples());
+  const int numChannels = juce::jmin(static_cast<int>(block.getNumChannels()),
+                                     static_cast<int>(Lanes::size()));
+
+  // collect the bands that change the signal, and clear the state of the
+  // others so that they start from silence once they are turned up again
+  std::array<Band *, maxBands> activeBands;
+  int numActiveBands = 0;
+  for (int band = 0; band < numBands; ++band) {
+    if (bands[band].isActive()) {
+      activeBands[numActiveBands++] = &bands[band];
+    } else {
+      bands[band].ic1eq = Lanes::expand(0.0f);
+      bands[band].ic2eq = Lanes::expand(0.0f);
+    }
+  }
+  if (numActiveBands == 0 || numSamples < 1 || numChannels < 1) {
+    return;
+  }
+
+  std::array<float *, Lanes::size()> channelData;
+  for (int channel = 0; channel < numChannels; ++channel) {
+    channelData[channel] = block.getChannelPointer(channel);
+  }
+
+  Lanes lanes = Lanes::expand(0.0f);
+  for (int sample = 0; sample < numSamples; ++sample) {
+    for (int channel = 0; channel < numChannels; ++channel) {
+      lanes.set(channel, channelData[channel][sample]);
+    }
+    for (int band = 0; band < numActiveBands; ++band) {
+      auto &activeBand = *activeBands[band];
+      if (activeBand.g.isSmoothing() || activeBand.a.isSmoothing()) {
+        activeBand.updateCoefficients(activeBand.g.getNextValue(),
+                                      activeBand.a.getNextValue());
+      }
+      lanes = activeBand.processSample(lanes);
+    }
+    for (int channel = 0; channel < numChannels; ++channel) {
+      channelData[channel][sample] = lanes.get(channel);
+    }
+  }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "ParameterRamp.h"
+#include <JuceHeader.h>
+
+// Multi-band EQ of shelving and peaking bands, all processed in a single
+// pass over the buffer with the channels in the lanes of a SIMD register.
+// Each band is a topology-preserving transform (TPT) state variable filter,
+// whose state stays valid when its coefficients change, so frequency and
+// gain are ramped per sample without zipper noise. Bands at unity gain are
+// skipped, and the stage costs nothing when all of them are.
+class Equalizer {
+public:
+  enum class BandType { lowShelf, highShelf, peak };
+
+  using Lanes = juce::dsp::SIMDRegister<float>;
+  static constexpr int maxBands = 4;
+
+  Equalizer(std::initializer_list<BandType> bandTypes);
+
+  // channels beyond the number of SIMD lanes are passed through
+  void prepare(const juce::dsp::ProcessSpec &spec);
+  void reset();
+
+  // sets the targets a band ramps to, snapping to them on the first call
+  // after prepare()
+  void setBandParameters(int band, float frequency, float gainDecibels,
+                         float quality = 0.7f);
+
+  void process(const juce::dsp::ProcessContextReplacing<float> &context);
+
+private:
+  struct Band {
+    BandType type = BandType::peak;
+    bool hasParameters = false;
+    float frequency = 0.0f;
+    float gainDecibels = 0.0f;
+    float quality = 0.0f;
+
+    // prewarped cutoff including the gain offset of shelves, and the square
+    // root of the band's linear gain
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> g;
+    juce::SmoothedValue<float, juce::ValueSmoothingTypes::Multiplicative> a;
+    float damping = 1.0f;
+
+    // SVF coefficients and output mix
+    float a1 = 1.0f, a2 = 0.0f, a3 = 0.0f;
+    float m0 = 1.0f, m1 = 0.0f, m2 = 0.0f;
+
+    // integrator states, one channel per lane
+    Lanes ic1eq = Lanes::expand(0.0f);
+    Lanes ic2eq = Lanes::expand(0.0f);
+
+    bool isActive() const;
+    void updateCoefficients(float newG, float newA);
+    Lanes processSample(Lanes input);
+  };
+
+  std::array<Band, maxBands> bands;
+  int numBands = 0;
+  double sampleRate = 44100.0;
+  bool isPrepared = false;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(Equalizer)
+};
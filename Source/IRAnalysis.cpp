@@ -0,0 +1,202 @@
+#include "IRAnalysis.h"
+
+namespace IRAnalysis {
+
+// samples scanned at once with the vectorised min/max search
+static const int scanBlockSize = 64;
+
+static float getMagnitude(const float *data, int numSamples) {
+  auto range = juce::FloatVectorOperations::findMinAndMax(data, numSamples);
+  return juce::jmax(-range.getStart(), range.getEnd());
+}
+
+int findOnsetSample(const juce::AudioBuffer<float> &buffer,
+                    float thresholdDecibels) {
+  const int numSamples = buffer.getNumSamples();
+  const int numChannels = buffer.getNumChannels();
+  if (numSamples < 1 || numChannels < 1) {
+    return 0;
+  }
+
+  const float threshold =
+      buffer.getMagnitude(0, numSamples) *
+      juce::Decibels::decibelsToGain(thresholdDecibels);
+  if (threshold <= 0.0f) {
+    return 0;
+  }
+
+  int onsetSample = numSamples;
+  int onsetChannel = 0;
+  for (int channel = 0; channel < numChannels; ++channel) {
+    const float *data = buffer.getReadPointer(channel);
+
+    // skip whole blocks below the threshold, then find the exact sample
+    // within the first block that reaches it. Stop at the onset found in the
+    // previous channels, as only an earlier one matters
+    for (int start = 0; start < onsetSample; start += scanBlockSize) {
+      const int size = juce::jmin(scanBlockSize, onsetSample - start);
+      if (getMagnitude(data + start, size) < threshold) {
+        continue;
+      }
+      for (int sample = start; sample < start + size; ++sample) {
+        if (std::abs(data[sample]) >= threshold) {
+          onsetSample = sample;
+          onsetChannel = channel;
+          break;
+        }
+      }
+      break;
+    }
+  }
+  if (onsetSample >= numSamples) {
+    return 0;
+  }
+
+  // the threshold is crossed on the rising edge of the wavefront, so step
+  // back to where that edge leaves zero
+  const float *data = buffer.getReadPointer(onsetChannel);
+  const bool isPositive = data[onsetSample] > 0.0f;
+  while (onsetSample > 0 && (data[onsetSample - 1] > 0.0f) == isPositive &&
+         data[onsetSample - 1] != 0.0f) {
+    --onsetSample;
+  }
+  return onsetSample;
+}
+
+// Fits a line to the EDC between the given levels, and returns the time the
+// fitted decay takes to fall by 60 dB.
+static float fitDecayTime(const std::vector<float> &edcDecibels,
+                          double sampleRate, float upperDecibels,
+                          float lowerDecibels) {
+  const int numSamples = static_cast<int>(edcDecibels.size());
+  int first = 0;
+  while (first < numSamples && edcDecibels[first] > upperDecibels) {
+    ++first;
+  }
+  int last = first;
+  while (last < numSamples && edcDecibels[last] > lowerDecibels) {
+    ++last;
+  }
+  if (last >= numSamples || last - first < 2) {
+    return 0.0f;
+  }
+
+  // least squares slope of level over sample index
+  const double count = last - first + 1;
+  double sumX = 0.0, sumY = 0.0, sumXX = 0.0, sumXY = 0.0;
+  for (int sample = first; sample <= last; ++sample) {
+    const double x = sample - first;
+    const double y = edcDecibels[sample];
+    sumX += x;
+    sumY += y;
+    sumXX += x * x;
+    sumXY += x * y;
+  }
+  const double slope =
+      (count * sumXY - sumX * sumY) / (count * sumXX - sumX * sumX);
+  if (slope >= 0.0) {
+    return 0.0f;
+  }
+  return static_cast<float>(-60.0 / slope / sampleRate);
+}
+
+DecayAnalysis analyseDecay(const juce::AudioBuffer<float> &buffer,
+                           double sampleRate, float truncationDecibels) {
+  DecayAnalysis analysis;
+  const int numSamples = buffer.getNumSamples();
+  const int numChannels = buffer.getNumChannels();
+  analysis.truncationSample = numSamples;
+  if (numSamples < 1 || numChannels < 1 || sampleRate <= 0.0) {
+    return analysis;
+  }
+
+  // energy envelope summed over the channels
+  std::vector<float> energy(numSamples);
+  std::vector<float> squares(numSamples);
+  juce::FloatVectorOperations::multiply(energy.data(), buffer.getReadPointer(0),
+                                        buffer.getReadPointer(0), numSamples);
+  for (int channel = 1; channel < numChannels; ++channel) {
+    const float *data = buffer.getReadPointer(channel);
+    juce::FloatVectorOperations::multiply(squares.data(), data, data,
+                                          numSamples);
+    juce::FloatVectorOperations::add(energy.data(), squares.data(),
+                                     numSamples);
+  }
+  const float peakEnergy =
+      juce::FloatVectorOperations::findMaximum(energy.data(), numSamples);
+  if (peakEnergy <= 0.0f) {
+    return analysis;
+  }
+
+  // estimate the noise floor from the last tenth of the IR
+  const int noiseLength = juce::jmax(1, numSamples / 10);
+  double noiseEnergy = 0.0;
+  for (int sample = numSamples - noiseLength; sample < numSamples; ++sample) {
+    noiseEnergy += energy[sample];
+  }
+  noiseEnergy /= noiseLength;
+  analysis.noiseFloorDecibels = static_cast<float>(
+      10.0 * std::log10(juce::jmax(noiseEnergy / peakEnergy, 1.0e-20)));
+
+  // integrating the noise would flatten the end of the curve, so stop where
+  // 10 ms averages of the decay come within 5 dB of the noise floor
+  const int windowSize = juce::jmax(1, static_cast<int>(sampleRate * 0.01));
+  const double noiseLimit = noiseEnergy * std::pow(10.0, 0.5);
+  int integrationLength = numSamples;
+  for (int end = numSamples; end > 0; end -= windowSize) {
+    const int start = juce::jmax(0, end - windowSize);
+    double windowEnergy = 0.0;
+    for (int sample = start; sample < end; ++sample) {
+      windowEnergy += energy[sample];
+    }
+    if (windowEnergy / (end - start) > noiseLimit) {
+      integrationLength = end;
+      break;
+    }
+  }
+
+  // Schroeder backward integration with the noise energy subtracted, the
+  // curve is stored in place of the energy envelope
+  std::vector<float> &edcDecibels = energy;
+  edcDecibels.resize(integrationLength);
+  double integral = 0.0;
+  for (int sample = integrationLength - 1; sample >= 0; --sample) {
+    integral += energy[sample] - noiseEnergy;
+    energy[sample] = static_cast<float>(juce::jmax(integral, 0.0));
+  }
+  const double totalEnergy = energy[0];
+  if (totalEnergy <= 0.0) {
+    return analysis;
+  }
+  for (int sample = 0; sample < integrationLength; ++sample) {
+    edcDecibels[sample] = static_cast<float>(
+        10.0 * std::log10(juce::jmax(energy[sample] / totalEnergy, 1.0e-20)));
+  }
+
+  // the EDC always falls steeply at its end, where the integration stops and
+  // the noise is subtracted, so a range is only fitted if it ends at least
+  // 10 dB above the noise floor
+  const float lowestFitDecibels = analysis.noiseFloorDecibels + 10.0f;
+  auto fitAboveNoise = [&](float lowerDecibels) {
+    return lowerDecibels >= lowestFitDecibels
+               ? fitDecayTime(edcDecibels, sampleRate, -5.0f, lowerDecibels)
+               : 0.0f;
+  };
+  analysis.t20 = fitAboveNoise(-25.0f);
+  analysis.t30 = fitAboveNoise(-35.0f);
+  analysis.t60 = fitAboveNoise(-65.0f);
+  if (analysis.t60 <= 0.0f) {
+    analysis.t60 = analysis.t30 > 0.0f ? analysis.t30 : analysis.t20;
+  }
+
+  analysis.truncationSample = integrationLength;
+  for (int sample = 0; sample < integrationLength; ++sample) {
+    if (edcDecibels[sample] <= truncationDecibels) {
+      analysis.truncationSample = sample + 1;
+      break;
+    }
+  }
+  return analysis;
+}
+
+} // namespace IRAnalysis
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Analysis helpers used to prepare a loaded impulse response.
+namespace IRAnalysis {
+
+// Reverberation times measured from the Schroeder energy decay curve (EDC) of
+// an IR, in seconds. A time is 0 when the IR's decay range is too short to
+// measure it.
+struct DecayAnalysis {
+  float t20 = 0.0f;
+  float t30 = 0.0f;
+  float t60 = 0.0f;
+  // noise floor relative to the peak energy
+  float noiseFloorDecibels = 0.0f;
+  // length where the EDC falls to the truncation level, or where the decay
+  // meets the noise floor if it doesn't get that far
+  int truncationSample = 0;
+};
+
+// Returns the sample index where the direct sound of the IR arrives, i.e. the
+// zero crossing preceding the first sample that rises to 'thresholdDecibels'
+// below the peak in any channel.
+int findOnsetSample(const juce::AudioBuffer<float> &buffer,
+                    float thresholdDecibels = -20.0f);
+
+// Integrates the energy of all channels backwards from the point where the
+// decay meets the noise floor, and fits the decay rates to the resulting EDC.
+// T20 and T30 are extrapolated from the -5...-25 dB and -5...-35 dB ranges,
+// T60 from -5...-65 dB, each only if the range ends at least 10 dB above the
+// noise floor. T60 falls back to T30 or T20 otherwise.
+DecayAnalysis analyseDecay(const juce::AudioBuffer<float> &buffer,
+                           double sampleRate,
+                           float truncationDecibels = -60.0f);
+
+} // namespace IRAnalysis
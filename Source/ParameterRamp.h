@@ -0,0 +1,27 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Helpers for processing with smoothed parameters. Every smoothed parameter
+// uses the same ramp time; while a value is static the callers take a
+// vectorised path with a constant, so smoothing costs nothing then.
+namespace ParameterRamp {
+
+// ramp time of all smoothed parameters, in seconds
+constexpr double rampTime = 0.05;
+
+// Writes the next 'numSamples' values of 'value' to 'dest'. Returns false
+// without advancing or writing anything if the value isn't ramping.
+template <typename SmoothingType>
+bool fill(juce::SmoothedValue<float, SmoothingType> &value, float *dest,
+          int numSamples) {
+  if (!value.isSmoothing()) {
+    return false;
+  }
+  for (int sample = 0; sample < numSamples; ++sample) {
+    dest[sample] = value.getNextValue();
+  }
+  return true;
+}
+
+} // namespace ParameterRamp
@@ -11,15 +11,20 @@
 
 //==============================================================================
 ConekoAudioProcessorEditor::ConekoAudioProcessorEditor(ConekoAudioProcessor &p)
-    : AudioProcessorEditor(&p), audioProcessor(p) {
+    : AudioProcessorEditor(&p), audioProcessor(p),
+      waveformDisplay(p.getWaveformOverview()), analyzerDisplay(p) {
   // Make sure that before the constructor has finished, you've set the
   // editor's size to whatever you need it to be.
-  setSize(750, 300);
+  setSize(750, 400);
   juce::LookAndFeel::setDefaultLookAndFeel(&customStyle);
 
   // set AudioFormatManager for reading IR file
   formatManager.registerBasicFormats();
 
+  // added first so that it stays behind the controls overlapping it
+  addAndMakeVisible(waveformDisplay);
+  addAndMakeVisible(analyzerDisplay);
+
   const auto sliderStyle = juce::Slider::RotaryHorizontalVerticalDrag;
   const auto sliderLabelJustification = juce::Justification::centred;
 
@@ -33,11 +38,7 @@ ConekoAudioProcessorEditor::ConekoAudioProcessorEditor(ConekoAudioProcessor &p)
   addAndMakeVisible(reverseButton);
   reverseButton.setButtonText("Reverse IR");
   reverseButton.setEnabled(enableIRParameters);
-  reverseButton.onClick = [this] {
-    audioProcessor.updateIRParameters();
-    shouldPaintWaveform = true;
-    repaint();
-  };
+  reverseButton.onClick = [this] { audioProcessor.updateIRParameters(); };
   reverseButtonAttachment = std::make_unique<APVTS::ButtonAttachment>(
       audioProcessor.apvts, "Reversed", reverseButton);
 
@@ -63,25 +64,38 @@ ConekoAudioProcessorEditor::ConekoAudioProcessorEditor(ConekoAudioProcessor &p)
 
   createSlider(decayTimeSlider, " s");
   decayTimeSlider.setEnabled(enableIRParameters);
-  decayTimeSlider.onDragEnd = [this] {
-    audioProcessor.updateIRParameters();
-    shouldPaintWaveform = true;
-    repaint();
-  };
+  decayTimeSlider.onDragEnd = [this] { audioProcessor.updateIRParameters(); };
   createLabel(decayTimeLabel, "Decay", &decayTimeSlider);
   decayTimeSliderAttachment = std::make_unique<APVTS::SliderAttachment>(
       audioProcessor.apvts, "DecayTime", decayTimeSlider);
 
+  addAndMakeVisible(decaySyncButton);
+  decaySyncButton.setButtonText("Sync");
+  decaySyncButton.onClick = [this] { audioProcessor.updateIRParameters(); };
+  decaySyncButtonAttachment = std::make_unique<APVTS::ButtonAttachment>(
+      audioProcessor.apvts, "DecaySync", decaySyncButton);
+
   createSlider(preDelayTimeSlider, " ms");
   // preDelayTimeSlider.onDragEnd = [this] {
   //  audioProcessor.updateIRParameters();
-  //  shouldPaintWaveform = true;
-  //  repaint();
   //};
   createLabel(preDelayTimeLabel, "Pre-delay", &preDelayTimeSlider);
   preDelayTimeSliderAttachment = std::make_unique<APVTS::SliderAttachment>(
       audioProcessor.apvts, "PreDelayTime", preDelayTimeSlider);
 
+  addAndMakeVisible(preDelayDivisionBox);
+  preDelayDivisionBox.addItemList(ConekoAudioProcessor::noteDivisionNames, 1);
+  createLabel(preDelayDivisionLabel, "Pre-delay", &preDelayDivisionBox);
+  preDelayDivisionBoxAttachment = std::make_unique<APVTS::ComboBoxAttachment>(
+      audioProcessor.apvts, "PreDelayDivision", preDelayDivisionBox);
+
+  addAndMakeVisible(preDelaySyncButton);
+  preDelaySyncButton.setButtonText("Sync");
+  preDelaySyncButton.onClick = [this] { updatePreDelayControls(); };
+  preDelaySyncButtonAttachment = std::make_unique<APVTS::ButtonAttachment>(
+      audioProcessor.apvts, "PreDelaySync", preDelaySyncButton);
+  updatePreDelayControls();
+
   createSlider(stereoWidthSlider, " %");
   createLabel(stereoWidthLabel, "Width", &stereoWidthSlider);
   stereoWidthSliderAttachment = std::make_unique<APVTS::SliderAttachment>(
@@ -106,6 +120,32 @@ ConekoAudioProcessorEditor::ConekoAudioProcessorEditor(ConekoAudioProcessor &p)
   createLabel(highShelfGainLabel, "HighGain", &highShelfGainSlider);
   highShelfGainSliderAttachment = std::make_unique<APVTS::SliderAttachment>(
       audioProcessor.apvts, "HighShelfGain", highShelfGainSlider);
+
+  // debug views of stage timings and realtime-safety violations, shown over
+  // the analyzer
+#if CONEKO_ENABLE_PROFILING
+  profilerOverlay = std::make_unique<ProfilerOverlay>(p.getProfiler());
+  addChildComponent(*profilerOverlay);
+#endif
+#if CONEKO_ENABLE_RT_TRACE
+  realtimeTraceView =
+      std::make_unique<RealtimeTraceView>(p.getRealtimeTracer());
+  addChildComponent(*realtimeTraceView);
+#endif
+#if CONEKO_ENABLE_PROFILING || CONEKO_ENABLE_RT_TRACE
+  addAndMakeVisible(debugButton);
+  debugButton.setButtonText("Debug");
+  debugButton.onClick = [this] {
+    const bool isVisible = debugButton.getToggleState();
+#if CONEKO_ENABLE_PROFILING
+    profilerOverlay->setVisible(isVisible);
+#endif
+#if CONEKO_ENABLE_RT_TRACE
+    realtimeTraceView->setVisible(isVisible);
+#endif
+  };
+  resized();
+#endif
 }
 
 ConekoAudioProcessorEditor::~ConekoAudioProcessorEditor() {
@@ -124,40 +164,6 @@ void ConekoAudioProcessorEditor::paint(juce::Graphics &g) {
   g.setColour(juce::Colour::fromRGB(111, 76, 91));
   g.drawFittedText("Coneko", getWidth() - 80 - 15, 15, 80, 20,
                    juce::Justification::centred, 1);
-
-  g.setColour(juce::Colour::fromRGB(158, 119, 119));
-
-  if (shouldPaintWaveform == true) {
-    const int waveformWidth = 80 * 3;
-    const int waveformHeight = 100;
-
-    juce::Path waveformPath;
-    waveformValues.clear();
-    waveformPath.startNewSubPath(15, waveformHeight + 60);
-
-    auto buffer = audioProcessor.getModifiedIR();
-    if (buffer.getNumSamples() < 1) {
-      buffer = audioProcessor.getOriginalIR();
-    }
-    const float waveformResolution = 1024.0f;
-    const int ratio =
-        static_cast<int>(buffer.getNumSamples() / waveformResolution);
-
-    auto bufferPointer = buffer.getReadPointer(0);
-    for (int sample = 0; sample < buffer.getNumSamples(); sample += ratio) {
-      waveformValues.push_back(juce::Decibels::gainToDecibels<float>(
-          std::fabsf(bufferPointer[sample]), -72.0f));
-    }
-    for (int xPos = 0; xPos < waveformValues.size(); ++xPos) {
-      auto yPos = juce::jmap<float>(waveformValues[xPos], -72.0f, 0.0f,
-                                    waveformHeight + 60, 60);
-      waveformPath.lineTo(15 + xPos / waveformResolution * waveformWidth, yPos);
-    }
-
-    g.strokePath(waveformPath, juce::PathStrokeType(1.0f));
-
-    shouldPaintWaveform = false;
-  }
 }
 
 void ConekoAudioProcessorEditor::resized() {
@@ -169,43 +175,75 @@ void ConekoAudioProcessorEditor::resized() {
   const int dialWidth = 80;
   const int dialHeight = 90;
 
+  // the analyzer spans the bottom, the controls are laid out above it
+  const int analyzerHeight = 100;
+  const int controlsHeight = getHeight() - analyzerHeight;
+  analyzerDisplay.setBounds(leftRightMargin, controlsHeight,
+                            getWidth() - leftRightMargin * 2,
+                            analyzerHeight - topBottomMargin);
+#if CONEKO_ENABLE_PROFILING || CONEKO_ENABLE_RT_TRACE
+  auto debugBounds = analyzerDisplay.getBounds();
+#if CONEKO_ENABLE_RT_TRACE
+  if (realtimeTraceView != nullptr) {
+    realtimeTraceView->setBounds(debugBounds.removeFromRight(170));
+  }
+#endif
+#if CONEKO_ENABLE_PROFILING
+  if (profilerOverlay != nullptr) {
+    profilerOverlay->setBounds(debugBounds);
+  }
+#endif
+  debugButton.setBounds(getWidth() - leftRightMargin - dialWidth * 2,
+                        topBottomMargin, dialWidth, 20);
+#endif
+
   openIRFileButton.setBounds(leftRightMargin, topBottomMargin, dialWidth * 3,
                              40);
+  waveformDisplay.setBounds(leftRightMargin, topBottomMargin + 45,
+                            dialWidth * 3, 100);
   irFileLabel.setBounds(leftRightMargin, topBottomMargin + 45, dialWidth * 3,
                         20);
   reverseButton.setBounds(leftRightMargin + dialWidth * 2, topBottomMargin + 40,
                           dialWidth, 30);
   bypassButton.setBounds(getWidth() - leftRightMargin - dialWidth * 3,
                          topBottomMargin, dialWidth, 20);
+  decaySyncButton.setBounds(leftRightMargin + dialWidth * 5, topBottomMargin,
+                            dialWidth, 20);
+  preDelaySyncButton.setBounds(getWidth() - leftRightMargin - dialWidth * 3,
+                               topBottomMargin + 22, dialWidth, 20);
   inputGainSlider.setBounds(leftRightMargin,
-                            getHeight() - topBottomMargin - dialHeight,
+                            controlsHeight - topBottomMargin - dialHeight,
                             dialWidth, dialHeight);
   outputGainSlider.setBounds(leftRightMargin + dialWidth,
-                             getHeight() - topBottomMargin - dialHeight,
+                             controlsHeight - topBottomMargin - dialHeight,
                              dialWidth, dialHeight);
   dryWetMixSlider.setBounds(leftRightMargin + dialWidth * 2,
-                            getHeight() - topBottomMargin - dialHeight,
+                            controlsHeight - topBottomMargin - dialHeight,
                             dialWidth, dialHeight);
-  decayTimeSlider.setBounds(leftRightMargin + dialWidth * 3,
-                            getHeight() - topBottomMargin - dialHeight * 3 + 30,
-                            dialWidth * 3, dialHeight * 3 - 30);
+  decayTimeSlider.setBounds(
+      leftRightMargin + dialWidth * 3,
+      controlsHeight - topBottomMargin - dialHeight * 3 + 30, dialWidth * 3,
+      dialHeight * 3 - 30);
   preDelayTimeSlider.setBounds(getWidth() - leftRightMargin - dialWidth * 3,
                                topBottomMargin + dialHeight / 3 * 2, dialWidth,
                                dialHeight);
+  preDelayDivisionBox.setBounds(
+      getWidth() - leftRightMargin - dialWidth * 3 + 5,
+      topBottomMargin + dialHeight / 3 * 2, dialWidth - 10, 24);
   stereoWidthSlider.setBounds(getWidth() - leftRightMargin - dialWidth * 3,
-                              getHeight() - topBottomMargin - dialHeight,
+                              controlsHeight - topBottomMargin - dialHeight,
                               dialWidth, dialHeight);
   lowShelfFreqSlider.setBounds(getWidth() - leftRightMargin - dialWidth * 2,
                                topBottomMargin + dialHeight / 3 * 2, dialWidth,
                                dialHeight);
   lowShelfGainSlider.setBounds(getWidth() - leftRightMargin - dialWidth * 2,
-                               getHeight() - topBottomMargin - dialHeight,
+                               controlsHeight - topBottomMargin - dialHeight,
                                dialWidth, dialHeight);
   highShelfFreqSlider.setBounds(getWidth() - leftRightMargin - dialWidth,
                                 topBottomMargin + dialHeight / 3 * 2, dialWidth,
                                 dialHeight);
   highShelfGainSlider.setBounds(getWidth() - leftRightMargin - dialWidth,
-                                getHeight() - topBottomMargin - dialHeight,
+                                controlsHeight - topBottomMargin - dialHeight,
                                 dialWidth, dialHeight);
 }
 
@@ -231,16 +269,21 @@ void ConekoAudioProcessorEditor::openButtonClicked() {
                      static_cast<int>(reader->lengthInSamples), 0, true, true);
         audioProcessor.loadImpulseResponse();
 
-        shouldPaintWaveform = true;
         enableIRParameters = true;
         reverseButton.setEnabled(enableIRParameters);
         decayTimeSlider.setEnabled(enableIRParameters);
-        repaint();
       }
     }
   });
 }
 
+void ConekoAudioProcessorEditor::updatePreDelayControls() {
+  // a synced pre-delay is set by note division instead of time
+  const bool isSynced = preDelaySyncButton.getToggleState();
+  preDelayTimeSlider.setVisible(!isSynced);
+  preDelayDivisionBox.setVisible(isSynced);
+}
+
 void ConekoAudioProcessorEditor::createSlider(juce::Slider &slider,
                                               juce::String textValueSuffix) {
   addAndMakeVisible(slider);
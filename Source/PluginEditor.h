@@ -8,8 +8,12 @@
 
 #pragma once
 
+#include "AnalyzerDisplay.h"
 #include "CustomStyle.h"
 #include "PluginProcessor.h"
+#include "ProfilerOverlay.h"
+#include "RealtimeTraceView.h"
+#include "WaveformDisplay.h"
 #include <JuceHeader.h>
 
 //==============================================================================
@@ -36,8 +40,17 @@ private:
   juce::AudioFormatManager formatManager;
   std::unique_ptr<juce::FileChooser> fileChooser;
 
-  std::vector<float> waveformValues;
-  bool shouldPaintWaveform = false;
+  WaveformDisplay waveformDisplay;
+  AnalyzerDisplay analyzerDisplay;
+#if CONEKO_ENABLE_PROFILING || CONEKO_ENABLE_RT_TRACE
+  juce::ToggleButton debugButton;
+#endif
+#if CONEKO_ENABLE_PROFILING
+  std::unique_ptr<ProfilerOverlay> profilerOverlay;
+#endif
+#if CONEKO_ENABLE_RT_TRACE
+  std::unique_ptr<RealtimeTraceView> realtimeTraceView;
+#endif
   bool enableIRParameters = false;
 
   juce::TextButton openIRFileButton;
@@ -61,6 +74,13 @@ private:
   juce::Slider preDelayTimeSlider;
   juce::Label preDelayTimeLabel;
   std::unique_ptr<APVTS::SliderAttachment> preDelayTimeSliderAttachment;
+  juce::ToggleButton preDelaySyncButton;
+  std::unique_ptr<APVTS::ButtonAttachment> preDelaySyncButtonAttachment;
+  juce::ComboBox preDelayDivisionBox;
+  juce::Label preDelayDivisionLabel;
+  std::unique_ptr<APVTS::ComboBoxAttachment> preDelayDivisionBoxAttachment;
+  juce::ToggleButton decaySyncButton;
+  std::unique_ptr<APVTS::ButtonAttachment> decaySyncButtonAttachment;
   juce::Slider stereoWidthSlider;
   juce::Label stereoWidthLabel;
   std::unique_ptr<APVTS::SliderAttachment> stereoWidthSliderAttachment;
@@ -78,6 +98,7 @@ private:
   std::unique_ptr<APVTS::SliderAttachment> highShelfGainSliderAttachment;
 
   void openButtonClicked();
+  void updatePreDelayControls();
   void createSlider(juce::Slider &slider, juce::String textValueSuffix);
   void createLabel(juce::Label &label, juce::String text,
                    juce::Component *slider);
@@ -9,6 +9,16 @@
 #include "PluginProcessor.h"
 #include "PluginEditor.h"
 
+const juce::StringArray ConekoAudioProcessor::noteDivisionNames = {
+    "1/64", "1/32", "1/16T", "1/16", "1/8T", "1/16D", "1/8",
+    "1/4T", "1/8D", "1/4",   "1/2T", "1/4D", "1/2"};
+
+// length of each note division in beats (quarter notes)
+static const double noteDivisionBeats[] = {
+    1.0 / 16.0, 1.0 / 8.0, 1.0 / 6.0, 1.0 / 4.0, 1.0 / 3.0,
+    3.0 / 8.0,  1.0 / 2.0, 2.0 / 3.0, 3.0 / 4.0, 1.0,
+    4.0 / 3.0,  3.0 / 2.0, 2.0};
+
 //==============================================================================
 ConekoAudioProcessor::ConekoAudioProcessor()
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -21,16 +31,18 @@ ConekoAudioProcessor::ConekoAudioProcessor()
               .withOutput("Output", juce::AudioChannelSet::stereo(), true)
 #endif
               ),
-      apvts(*this, nullptr, "Parameters", createParameters()),
-      lowShelfFilter(juce::dsp::IIR::Coefficients<float>::makeLowShelf(
-          44100, 20.0f, 1.0f, 0.7f)),
-      highShelfFilter(juce::dsp::IIR::Coefficients<float>::makeHighShelf(
-          44100, 20000.0f, 1.0f, 0.7f))
+      apvts(*this, nullptr, "Parameters", createParameters())
 #endif
 {
+  // sized once, as the analyzer may read them whenever the editor is open
+  dryAnalyzerFifo.prepare(32768);
+  wetAnalyzerFifo.prepare(32768);
+
+  // picks up the IR updates requested by the audio thread
+  startTimerHz(20);
 }
 
-ConekoAudioProcessor::~ConekoAudioProcessor() {}
+ConekoAudioProcessor::~ConekoAudioProcessor() { stopTimer(); }
 
 //==============================================================================
 const juce::String ConekoAudioProcessor::getName() const {
@@ -92,27 +104,64 @@ void ConekoAudioProcessor::prepareToPlay(double sampleRate,
   soundtouch.setSampleRate(sampleRate);
   soundtouch.setChannels(1);
 
+  // smoothed parameters start at their current values instead of ramping
+  // from the defaults
   inputGainer.prepare(spec);
+  inputGainer.setRampDurationSeconds(ParameterRamp::rampTime);
+  inputGainer.setGainDecibels(apvts.getRawParameterValue("InputGain")->load());
   inputGainer.reset();
   outputGainer.prepare(spec);
+  outputGainer.setRampDurationSeconds(ParameterRamp::rampTime);
+  outputGainer.setGainDecibels(
+      apvts.getRawParameterValue("OutputGain")->load());
   outputGainer.reset();
-  dryWetMixer.prepare(spec);
-  dryWetMixer.reset();
+  wetMix.reset(sampleRate, ParameterRamp::rampTime);
+  wetMix.setCurrentAndTargetValue(
+      apvts.getRawParameterValue("DryWetMix")->load() / 100.0f);
+  bypassMix.reset(sampleRate, ParameterRamp::rampTime);
+  bypassMix.setCurrentAndTargetValue(
+      apvts.getRawParameterValue("Bypassed")->load() == true ? 1.0f : 0.0f);
+  stereoWidth.reset(sampleRate, ParameterRamp::rampTime);
+  stereoWidth.setCurrentAndTargetValue(
+      apvts.getRawParameterValue("StereoWidth")->load() / 100.0f);
+  rampBuffer.setSize(1, samplesPerBlock);
+  dryBuffer.setSize(spec.numChannels, samplesPerBlock);
+  bypassBuffer.setSize(spec.numChannels, samplesPerBlock);
+  isWetPathIdle = false;
+  dryOnlySamples = 0;
   delay.prepare(spec);
-  delay.setMaximumDelayInSamples(sampleRate);
+  delay.setMaximumDelayInSamples(
+      static_cast<int>(std::ceil(maxPreDelayTime * sampleRate)));
   delay.reset();
+  preDelaySamples.reset(sampleRate, ParameterRamp::rampTime);
+  preDelaySamples.setCurrentAndTargetValue(
+      apvts.getRawParameterValue("PreDelayTime")->load() / 1000.0 *
+      sampleRate);
+  tempoDetector.prepare(sampleRate);
+  // the convolver resamples the installed IR to a new sample rate, which
+  // breaks the length rule of baked IRs. Remember what it was until the IR
+  // is rebuilt at the new rate, as a plain IR that is baked again later
+  const bool wasBakedIRInstalled = isBakedIRInstalled();
   convolver.prepare(spec);
   convolver.reset();
+  if (sampleRate != preparedSampleRate) {
+    preparedSampleRate = sampleRate;
+    isResampledIRBaked = wasBakedIRInstalled;
+    resampledIRSize.store(convolver.getCurrentIRSize());
+    shouldBakeEQ.store(false);
+    previousEQ = getEQSettings();
+    eqStaticSamples = 0;
+    isStretchPending.store(true);
+  }
 
-  lowShelfFilter.prepare(spec);
-  lowShelfFilter.reset();
-  highShelfFilter.prepare(spec);
-  highShelfFilter.reset();
+  equalizer.prepare(spec);
+  updateFilterParameters();
 }
 
 void ConekoAudioProcessor::releaseResources() {
   // When playback stops, you can use this as an opportunity to free up any
   // spare memory, etc.
+  tempoDetector.stop();
 }
 
 #ifndef JucePlugin_PreferredChannelConfigurations
@@ -144,6 +193,8 @@ bool ConekoAudioProcessor::isBusesLayoutSupported(
 void ConekoAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
                                         juce::MidiBuffer &midiMessages) {
   juce::ScopedNoDenormals noDenormals;
+  CONEKO_TRACE_BLOCK(realtimeTracer, buffer.getNumSamples(), getSampleRate());
+  CONEKO_PROFILE_STAGE(profiler, wholeBlock);
   auto totalNumInputChannels = getTotalNumInputChannels();
   auto totalNumOutputChannels = getTotalNumOutputChannels();
 
@@ -161,45 +212,240 @@ void ConekoAudioProcessor::processBlock(juce::AudioBuffer<float> &buffer,
   auto outputGainValue = apvts.getRawParameterValue("OutputGain");
   auto dryWetMixValue = apvts.getRawParameterValue("DryWetMix");
   auto preDelayTimeValue = apvts.getRawParameterValue("PreDelayTime");
+  auto preDelaySyncValue = apvts.getRawParameterValue("PreDelaySync");
+  auto preDelayDivisionValue = apvts.getRawParameterValue("PreDelayDivision");
+  auto decaySyncValue = apvts.getRawParameterValue("DecaySync");
   auto stereoWidthValue = apvts.getRawParameterValue("StereoWidth");
   auto isBypassed = apvts.getRawParameterValue("Bypassed");
-  updateFilterParameters();
+  const bool shouldFeedAnalyzer = isAnalyzerActive.load();
+  {
+    CONEKO_TRACE_STAGE(filterUpdate);
+    updateEQBaking(buffer.getNumSamples());
+    updateFilterParameters();
+  }
+
+  // the tempo is only detected from the input when something is synced to
+  // it and the host doesn't report one. Keep it running while bypassed, so
+  // that it is ready
+  const bool isDecaySynced = decaySyncValue->load() == true;
+  const double hostBpm = getHostBpm();
+  if (hostBpm <= 0.0 && (isDecaySynced || preDelaySyncValue->load() == true)) {
+    tempoDetector.pushSamples(buffer);
+  }
+  const double bpm = hostBpm > 0.0 ? hostBpm : tempoDetector.getBpm();
+  currentBpm.store(bpm);
+
+  // re-stretch the IR on the message thread once the synced decay spans a
+  // different number of sixteenths, tempo drift within one doesn't matter
+  const int decaySixteenths =
+      isDecaySynced ? getDecaySixteenths(
+                          irSamplesPerDecaySecond.load() *
+                              apvts.getRawParameterValue("DecayTime")->load(),
+                          bpm)
+                    : 0;
+  if (decaySixteenths != irDecaySixteenths.load()) {
+    isStretchPending.store(true);
+  }
 
-  if (isBypassed->load() == true) {
+  // crossfade into the bypass, then skip all processing until it is turned
+  // off again
+  bypassMix.setTargetValue(isBypassed->load() == true ? 1.0f : 0.0f);
+  if (!bypassMix.isSmoothing() && bypassMix.getTargetValue() == 1.0f) {
+    isWetPathIdle = true;
     return;
   }
 
   inputGainer.setGainDecibels(inputGainValue->load());
   outputGainer.setGainDecibels(outputGainValue->load());
-  dryWetMixer.setWetMixProportion(dryWetMixValue->load() / 100.0f);
-  delay.setDelay(preDelayTimeValue->load() / 1000.0 * this->getSampleRate());
+  wetMix.setTargetValue(dryWetMixValue->load() / 100.0f);
+  stereoWidth.setTargetValue(stereoWidthValue->load() / 100.0f);
+  if (preDelaySyncValue->load() == true && bpm > 0.0) {
+    preDelaySamples.setTargetValue(getSyncedPreDelaySamples(
+        bpm, static_cast<int>(preDelayDivisionValue->load())));
+  } else {
+    preDelaySamples.setTargetValue(preDelayTimeValue->load() / 1000.0 *
+                                   this->getSampleRate());
+  }
+
+  // hosts may send larger blocks than announced in prepareToPlay, those are
+  // processed in pieces that fit the prepared buffers
+  const int numChannels =
+      juce::jmin(buffer.getNumChannels(), dryBuffer.getNumChannels());
+  const int chunkSize = dryBuffer.getNumSamples();
+  for (int start = 0; start < buffer.getNumSamples() && chunkSize > 0;
+       start += chunkSize) {
+    juce::AudioBuffer<float> subBuffer(
+        buffer.getArrayOfWritePointers(), numChannels, start,
+        juce::jmin(chunkSize, buffer.getNumSamples() - start));
+    processSubBlock(subBuffer, shouldFeedAnalyzer);
+  }
+}
+
+void ConekoAudioProcessor::processSubBlock(juce::AudioBuffer<float> &buffer,
+                                           bool shouldFeedAnalyzer) {
+  const int numSamples = buffer.getNumSamples();
+  const int numChannels = buffer.getNumChannels();
+  const bool isBypassFading = bypassMix.isSmoothing();
+  if (isBypassFading) {
+    for (int channel = 0; channel < numChannels; ++channel) {
+      bypassBuffer.copyFrom(channel, 0, buffer, channel, 0, numSamples);
+    }
+  }
 
   auto block = juce::dsp::AudioBlock<float>(buffer);
   auto context = juce::dsp::ProcessContextReplacing<float>(block);
-  inputGainer.process(context);
-  dryWetMixer.pushDrySamples(block);
-  convolver.process(context);
-  delay.process(context);
-
-  // set stereo width using mid/side technique
-  if (context.getInputBlock().getNumChannels() == 2) {
-    const float width = stereoWidthValue->load() / 100.0;
-    for (int sample = 0; sample < context.getInputBlock().getNumSamples();
-         ++sample) {
-      float left = context.getInputBlock().getSample(0, sample);
-      float right = context.getInputBlock().getSample(1, sample);
-      context.getOutputBlock().setSample(
-          0, sample, left * (1 + width) / 2 + right * (1 - width) / 2);
-      context.getOutputBlock().setSample(
-          1, sample, left * (1 - width) / 2 + right * (1 + width) / 2);
+  {
+    CONEKO_PROFILE_STAGE(profiler, inputGain);
+    inputGainer.process(context);
+  }
+  if (shouldFeedAnalyzer) {
+    dryAnalyzerFifo.push(buffer.getArrayOfReadPointers(),
+                         buffer.getNumChannels(), buffer.getNumSamples());
+  }
+
+  // a fully wet mix needs no copy of the dry signal. A fully dry one keeps
+  // the wet path running until the tail of what was fed into it has passed,
+  // so that the mix can come back without a gap, and then idles it
+  const bool isWetOnly =
+      !wetMix.isSmoothing() && wetMix.getTargetValue() == 1.0f;
+  const bool isDryOnly =
+      !wetMix.isSmoothing() && wetMix.getTargetValue() == 0.0f;
+  const int tailSamples =
+      convolver.getCurrentIRSize() +
+      static_cast<int>(std::ceil(preDelaySamples.getTargetValue()));
+  dryOnlySamples =
+      isDryOnly ? juce::jmin(dryOnlySamples + numSamples, tailSamples + 1) : 0;
+  if (!isDryOnly || dryOnlySamples <= tailSamples) {
+    if (isWetPathIdle) {
+      // the wet path missed the signal while idle, start it from silence
+      convolver.reset();
+      delay.reset();
+      equalizer.reset();
+      isWetPathIdle = false;
+    }
+    if (!isWetOnly) {
+      CONEKO_PROFILE_STAGE(profiler, dryWetMix);
+      for (int channel = 0; channel < numChannels; ++channel) {
+        dryBuffer.copyFrom(channel, 0, buffer, channel, 0, numSamples);
+      }
+    }
+    processWetPath(buffer, shouldFeedAnalyzer);
+    if (!isWetOnly) {
+      CONEKO_PROFILE_STAGE(profiler, dryWetMix);
+      mixDrySamples(buffer);
+    }
+  } else {
+    isWetPathIdle = true;
+  }
+
+  {
+    CONEKO_PROFILE_STAGE(profiler, outputGain);
+    outputGainer.process(context);
+  }
+  if (isBypassFading) {
+    CONEKO_PROFILE_STAGE(profiler, dryWetMix);
+    crossfadeBypass(buffer);
+  }
+}
+
+void ConekoAudioProcessor::processWetPath(juce::AudioBuffer<float> &buffer,
+                                          bool shouldFeedAnalyzer) {
+  auto block = juce::dsp::AudioBlock<float>(buffer);
+  auto context = juce::dsp::ProcessContextReplacing<float>(block);
+  {
+    CONEKO_PROFILE_STAGE(profiler, convolution);
+    convolver.process(context);
+  }
+
+  if (preDelaySamples.isSmoothing()) {
+    CONEKO_PROFILE_STAGE(profiler, preDelay);
+    // glide the delay per sample, so that tempo or division changes don't
+    // click and the delay line doesn't need to be re-prepared
+    for (int sample = 0; sample < block.getNumSamples(); ++sample) {
+      delay.setDelay(preDelaySamples.getNextValue());
+      for (int channel = 0; channel < block.getNumChannels(); ++channel) {
+        delay.pushSample(channel, block.getSample(channel, sample));
+        block.setSample(channel, sample, delay.popSample(channel));
+      }
     }
+  } else {
+    CONEKO_PROFILE_STAGE(profiler, preDelay);
+    delay.setDelay(preDelaySamples.getNextValue());
+    delay.process(context);
+  }
+
+  if (block.getNumChannels() == 2) {
+    CONEKO_PROFILE_STAGE(profiler, stereoWidth);
+    processStereoWidth(block);
+  }
+
+  {
+    CONEKO_PROFILE_STAGE(profiler, equalizer);
+    equalizer.process(context);
   }
 
-  lowShelfFilter.process(context);
-  highShelfFilter.process(context);
+  if (shouldFeedAnalyzer) {
+    wetAnalyzerFifo.push(buffer.getArrayOfReadPointers(),
+                         buffer.getNumChannels(), buffer.getNumSamples());
+  }
+}
+
+void ConekoAudioProcessor::mixDrySamples(juce::AudioBuffer<float> &buffer) {
+  const int numSamples = buffer.getNumSamples();
+  const int numChannels = buffer.getNumChannels();
+  if (!wetMix.isSmoothing()) {
+    const float wet = wetMix.getTargetValue();
+    for (int channel = 0; channel < numChannels; ++channel) {
+      if (wet == 0.0f) {
+        buffer.copyFrom(channel, 0, dryBuffer, channel, 0, numSamples);
+      } else {
+        buffer.applyGain(channel, 0, numSamples, wet);
+        buffer.addFrom(channel, 0, dryBuffer, channel, 0, numSamples,
+                       1.0f - wet);
+      }
+    }
+    return;
+  }
 
-  dryWetMixer.mixWetSamples(block);
-  outputGainer.process(context);
+  // linear crossfade between the dry and the wet signal
+  const int chunkSize = rampBuffer.getNumSamples();
+  float *ramp = rampBuffer.getWritePointer(0);
+  for (int start = 0; start < numSamples && chunkSize > 0;
+       start += chunkSize) {
+    const int size = juce::jmin(chunkSize, numSamples - start);
+    if (!ParameterRamp::fill(wetMix, ramp, size)) {
+      juce::FloatVectorOperations::fill(ramp, wetMix.getTargetValue(), size);
+    }
+    for (int channel = 0; channel < numChannels; ++channel) {
+      float *wet = buffer.getWritePointer(channel, start);
+      const float *dry = dryBuffer.getReadPointer(channel, start);
+      for (int sample = 0; sample < size; ++sample) {
+        wet[sample] = dry[sample] + (wet[sample] - dry[sample]) * ramp[sample];
+      }
+    }
+  }
+}
+
+void ConekoAudioProcessor::crossfadeBypass(juce::AudioBuffer<float> &buffer) {
+  const int numSamples = buffer.getNumSamples();
+  const int chunkSize = rampBuffer.getNumSamples();
+  float *ramp = rampBuffer.getWritePointer(0);
+  for (int start = 0; start < numSamples && chunkSize > 0;
+       start += chunkSize) {
+    const int size = juce::jmin(chunkSize, numSamples - start);
+    if (!ParameterRamp::fill(bypassMix, ramp, size)) {
+      juce::FloatVectorOperations::fill(ramp, bypassMix.getTargetValue(),
+                                        size);
+    }
+    for (int channel = 0; channel < buffer.getNumChannels(); ++channel) {
+      float *processed = buffer.getWritePointer(channel, start);
+      const float *input = bypassBuffer.getReadPointer(channel, start);
+      for (int sample = 0; sample < size; ++sample) {
+        processed[sample] +=
+            (input[sample] - processed[sample]) * ramp[sample];
+      }
+    }
+  }
 }
 
 //==============================================================================
@@ -242,86 +488,200 @@ juce::AudioBuffer<float> &ConekoAudioProcessor::getModifiedIR() {
   return modifiedIRBuffer;
 }
 
+const IRAnalysis::DecayAnalysis &
+ConekoAudioProcessor::getDecayAnalysis() const {
+  return decayAnalysis;
+}
+
+WaveformOverview &ConekoAudioProcessor::getWaveformOverview() {
+  return waveformOverview;
+}
+
+SampleFifo &ConekoAudioProcessor::getDryAnalyzerFifo() {
+  return dryAnalyzerFifo;
+}
+
+SampleFifo &ConekoAudioProcessor::getWetAnalyzerFifo() {
+  return wetAnalyzerFifo;
+}
+
+std::atomic<bool> &ConekoAudioProcessor::getAnalyzerActiveFlag() {
+  return isAnalyzerActive;
+}
+
+#if CONEKO_ENABLE_PROFILING
+StageProfiler &ConekoAudioProcessor::getProfiler() { return profiler; }
+#endif
+
+#if CONEKO_ENABLE_RT_TRACE
+RealtimeTracer &ConekoAudioProcessor::getRealtimeTracer() {
+  return realtimeTracer;
+}
+#endif
+
 void ConekoAudioProcessor::loadImpulseResponse() {
   // normalized IR signal
   float globalMaxMagnitude =
       originalIRBuffer.getMagnitude(0, originalIRBuffer.getNumSamples());
   originalIRBuffer.applyGain(1.0f / (globalMaxMagnitude + 0.01));
 
-  // trim IR signal
+  // trim IR signal, starting a little before the direct sound arrives
   int numSamples = originalIRBuffer.getNumSamples();
-  int blockSize = static_cast<int>(std::floor(this->getSampleRate()) / 100);
-  int startBlockNum = 0;
-  int endBlockNum = numSamples / blockSize;
-  float localMaxMagnitude = 0.0f;
-  while ((startBlockNum + 1) * blockSize < numSamples) {
-    localMaxMagnitude =
-        originalIRBuffer.getMagnitude(startBlockNum * blockSize, blockSize);
-    // find the start position of IR
-    if (localMaxMagnitude > 0.001) {
-      break;
-    }
-    ++startBlockNum;
-  }
-  localMaxMagnitude = 0.0f;
-  while ((endBlockNum - 1) * blockSize > 0) {
-    --endBlockNum;
-    localMaxMagnitude =
-        originalIRBuffer.getMagnitude(endBlockNum * blockSize, blockSize);
-    // find the time to decay by 60 dB (T60)
-    if (localMaxMagnitude > 0.001) {
-      break;
-    }
-  }
+  int fadeInSamples =
+      static_cast<int>(std::round(this->getSampleRate() * 0.0005));
+  int startSample = juce::jmax(
+      0, IRAnalysis::findOnsetSample(originalIRBuffer) - fadeInSamples);
+  fadeInSamples = juce::jmin(fadeInSamples, numSamples - startSample);
+
+  // truncate the tail where its energy decay falls to the truncation level
+  juce::AudioBuffer<float> onsetIRBuffer(
+      originalIRBuffer.getArrayOfWritePointers(),
+      originalIRBuffer.getNumChannels(), startSample, numSamples - startSample);
+  decayAnalysis = IRAnalysis::analyseDecay(onsetIRBuffer, this->getSampleRate(),
+                                           irTruncationLevel);
+  int trimmedNumSamples =
+      juce::jlimit(juce::jmin(fadeInSamples + 1, numSamples - startSample),
+                   numSamples - startSample, decayAnalysis.truncationSample);
+  int fadeOutSamples = juce::jmin(
+      static_cast<int>(std::round(this->getSampleRate() * 0.05)),
+      trimmedNumSamples / 4);
 
-  int trimmedNumSamples;
-  if (endBlockNum * blockSize < numSamples) {
-    trimmedNumSamples = (endBlockNum - startBlockNum) * blockSize - 1;
-  } else {
-    trimmedNumSamples = numSamples - startBlockNum * blockSize;
-  }
   modifiedIRBuffer.setSize(originalIRBuffer.getNumChannels(), trimmedNumSamples,
                            false, true, false);
   for (int channel = 0; channel < originalIRBuffer.getNumChannels();
        ++channel) {
-    for (int sample = 0; sample < trimmedNumSamples; ++sample) {
-      modifiedIRBuffer.setSample(
-          channel, sample,
-          originalIRBuffer.getSample(channel,
-                                     sample + startBlockNum * blockSize));
-    }
+    modifiedIRBuffer.copyFrom(channel, 0, originalIRBuffer, channel,
+                              startSample, trimmedNumSamples);
+    // fade in the pre-roll and out the tail so that the cuts don't click
+    modifiedIRBuffer.applyGainRamp(channel, 0, fadeInSamples, 0.0f, 1.0f);
+    modifiedIRBuffer.applyGainRamp(channel, trimmedNumSamples - fadeOutSamples,
+                                   fadeOutSamples, 1.0f, 0.0f);
   }
 
   originalIRBuffer.makeCopyOf(modifiedIRBuffer);
 
+  // the decay time is the measured T60, or the IR length if the decay range
+  // is too short to measure it
+  measuredDecayTime = decayAnalysis.t60 > 0.0f
+                          ? decayAnalysis.t60
+                          : trimmedNumSamples / this->getSampleRate();
   auto decayTimeParam = apvts.getParameter("DecayTime");
-  double decayTime =
-      static_cast<double>(trimmedNumSamples) / this->getSampleRate();
   decayTimeParam->beginChangeGesture();
   decayTimeParam->setValueNotifyingHost(
-      decayTimeParam->convertTo0to1(decayTime));
+      decayTimeParam->convertTo0to1(static_cast<float>(measuredDecayTime)));
   decayTimeParam->endChangeGesture();
+  irSamplesPerDecaySecond.store(trimmedNumSamples / measuredDecayTime);
+  irDecaySixteenths.store(0);
 
   updateImpulseResponse(modifiedIRBuffer);
 }
 
 void ConekoAudioProcessor::updateImpulseResponse(
     juce::AudioBuffer<float> irBuffer) {
+  waveformOverview.rebuild(irBuffer);
+  loadConvolverIR(std::move(irBuffer));
+}
+
+void ConekoAudioProcessor::loadConvolverIR(juce::AudioBuffer<float> irBuffer) {
+  const bool shouldBake = shouldBakeEQ.load();
+  isLoadedIRBaked = shouldBake;
+  if (irBuffer.getNumSamples() < 1) {
+    return;
+  }
+
+  // normalise before the EQ is baked in, so that the EQ isn't normalised
+  // away; this is the same scaling the convolver would apply itself
+  float maxEnergy = 0.0f;
+  for (int channel = 0; channel < irBuffer.getNumChannels(); ++channel) {
+    const float *data = irBuffer.getReadPointer(channel);
+    float energy = 0.0f;
+    for (int sample = 0; sample < irBuffer.getNumSamples(); ++sample) {
+      energy += data[sample] * data[sample];
+    }
+    maxEnergy = juce::jmax(maxEnergy, energy);
+  }
+  if (maxEnergy > 0.0f) {
+    irBuffer.applyGain(0.125f / std::sqrt(maxEnergy));
+  }
+
+  if (shouldBake) {
+    EQSettings settings;
+    {
+      const juce::SpinLock::ScopedLockType lock(bakeRequestLock);
+      settings = requestedEQ;
+    }
+    bakeEQ(irBuffer, settings, this->getSampleRate());
+  }
+  // pad to the length rule, and away from the length of a resampled IR so
+  // that the audio thread can tell when this one is installed
+  int numSamples = irBuffer.getNumSamples();
+  if (isBakedIRLength(numSamples) != shouldBake) {
+    ++numSamples;
+  }
+  if (numSamples == resampledIRSize.load()) {
+    numSamples += 2;
+  }
+  if (numSamples != irBuffer.getNumSamples()) {
+    irBuffer.setSize(irBuffer.getNumChannels(), numSamples, true, true, false);
+  }
+
   convolver.loadImpulseResponse(std::move(irBuffer), this->getSampleRate(),
                                 juce::dsp::Convolution::Stereo::yes,
                                 juce::dsp::Convolution::Trim::no,
-                                juce::dsp::Convolution::Normalise::yes);
+                                juce::dsp::Convolution::Normalise::no);
+}
+
+void ConekoAudioProcessor::bakeEQ(juce::AudioBuffer<float> &irBuffer,
+                                  const EQSettings &settings,
+                                  double sampleRate) {
+  const int numSamples = irBuffer.getNumSamples();
+
+  // the live filters are linear, so running the IR through the same ones
+  // gives the same magnitude and phase response
+  Equalizer irEqualizer{Equalizer::BandType::lowShelf,
+                        Equalizer::BandType::highShelf};
+  const int numChannels =
+      juce::jmin(irBuffer.getNumChannels(),
+                 static_cast<int>(Equalizer::Lanes::size()));
+  irEqualizer.prepare({sampleRate, static_cast<juce::uint32>(numSamples),
+                       static_cast<juce::uint32>(numChannels)});
+  irEqualizer.setBandParameters(lowShelfBand, settings.lowShelfFreq,
+                                settings.lowShelfGain);
+  irEqualizer.setBandParameters(highShelfBand, settings.highShelfFreq,
+                                settings.highShelfGain);
+  auto block = juce::dsp::AudioBlock<float>(irBuffer);
+  irEqualizer.process(juce::dsp::ProcessContextReplacing<float>(block));
 }
 
 void ConekoAudioProcessor::updateIRParameters() {
   if (originalIRBuffer.getNumSamples() < 1) {
+    irSamplesPerDecaySecond.store(0.0);
+    irDecaySixteenths.store(0);
     return;
   }
 
-  // stretch IR according to decay time
+  // stretch IR so that its measured decay time becomes the set one
   auto decayTimeValue = apvts.getRawParameterValue("DecayTime");
+  double irDecayTime = measuredDecayTime > 0.0
+                           ? measuredDecayTime
+                           : originalIRBuffer.getNumSamples() /
+                                 this->getSampleRate();
+  irSamplesPerDecaySecond.store(originalIRBuffer.getNumSamples() /
+                                irDecayTime);
   int decaySample = static_cast<int>(
-      std::round(decayTimeValue->load() * this->getSampleRate()));
+      std::round(originalIRBuffer.getNumSamples() * decayTimeValue->load() /
+                 irDecayTime));
+
+  // snap decay time to whole sixteenth notes of the tempo
+  auto decaySyncValue = apvts.getRawParameterValue("DecaySync");
+  const double bpm = currentBpm.load();
+  const int decaySixteenths =
+      decaySyncValue->load() == true ? getDecaySixteenths(decaySample, bpm) : 0;
+  irDecaySixteenths.store(decaySixteenths);
+  if (decaySixteenths > 0) {
+    decaySample = static_cast<int>(std::round(
+        decaySixteenths * 60.0 / bpm / 4.0 * this->getSampleRate()));
+  }
   double stretchRatio =
       originalIRBuffer.getNumSamples() / static_cast<double>(decaySample);
 
@@ -362,18 +722,182 @@ void ConekoAudioProcessor::updateIRParameters() {
 }
 
 void ConekoAudioProcessor::updateFilterParameters() {
-  const float sampleRate = this->getSampleRate();
+  // nothing is filtered live while the IR has the current EQ baked in. Once
+  // the EQ moves away from it, the baked shelves are cancelled by their
+  // inverse, which is the same shelf with negated gain, and the current ones
+  // are applied on top until the convolver has switched to a plain IR
+  const auto settings = getEQSettings();
+  const bool isBakedIR = isBakedIRInstalled();
+  const bool isBakedEQCurrent = isBakedIR && settings == bakedEQ;
+  const bool shouldCancelBakedEQ = isBakedIR && !isBakedEQCurrent;
+
+  // the bands ramp to the new values themselves, and only recompute their
+  // targets when a value actually changed
+  equalizer.setBandParameters(lowShelfBand, settings.lowShelfFreq,
+                              isBakedEQCurrent ? 0.0f : settings.lowShelfGain);
+  equalizer.setBandParameters(highShelfBand, settings.highShelfFreq,
+                              isBakedEQCurrent ? 0.0f
+                                               : settings.highShelfGain);
+  equalizer.setBandParameters(
+      bakedLowShelfBand, bakedEQ.lowShelfFreq,
+      shouldCancelBakedEQ ? -bakedEQ.lowShelfGain : 0.0f);
+  equalizer.setBandParameters(
+      bakedHighShelfBand, bakedEQ.highShelfFreq,
+      shouldCancelBakedEQ ? -bakedEQ.highShelfGain : 0.0f);
+}
+
+ConekoAudioProcessor::EQSettings ConekoAudioProcessor::getEQSettings() {
+  EQSettings settings;
+  settings.lowShelfFreq = apvts.getRawParameterValue("LowShelfFreq")->load();
+  settings.lowShelfGain = apvts.getRawParameterValue("LowShelfGain")->load();
+  settings.highShelfFreq = apvts.getRawParameterValue("HighShelfFreq")->load();
+  settings.highShelfGain = apvts.getRawParameterValue("HighShelfGain")->load();
+  return settings;
+}
 
-  auto lowShelfFreqValue = apvts.getRawParameterValue("LowShelfFreq");
-  auto lowShelfGainValue = apvts.getRawParameterValue("LowShelfGain");
-  auto highShelfFreqValue = apvts.getRawParameterValue("HighShelfFreq");
-  auto highShelfGainValue = apvts.getRawParameterValue("HighShelfGain");
-  *lowShelfFilter.state = *juce::dsp::IIR::Coefficients<float>::makeLowShelf(
-      sampleRate, lowShelfFreqValue->load(), 0.7f,
-      juce::Decibels::decibelsToGain(lowShelfGainValue->load()));
-  *highShelfFilter.state = *juce::dsp::IIR::Coefficients<float>::makeHighShelf(
-      sampleRate, highShelfFreqValue->load(), 0.7f,
-      juce::Decibels::decibelsToGain(highShelfGainValue->load()));
+bool ConekoAudioProcessor::EQSettings::operator==(
+    const EQSettings &other) const {
+  return lowShelfFreq == other.lowShelfFreq &&
+         lowShelfGain == other.lowShelfGain &&
+         highShelfFreq == other.highShelfFreq &&
+         highShelfGain == other.highShelfGain;
+}
+
+bool ConekoAudioProcessor::EQSettings::operator!=(
+    const EQSettings &other) const {
+  return !(*this == other);
+}
+
+void ConekoAudioProcessor::updateEQBaking(int numSamples) {
+  const auto settings = getEQSettings();
+  if (settings != previousEQ) {
+    previousEQ = settings;
+    eqStaticSamples = 0;
+  } else if (eqStaticSamples < eqBakeDelay * getSampleRate()) {
+    eqStaticSamples += numSamples;
+  }
+  const bool isBakingEnabled =
+      apvts.getRawParameterValue("BakeEQ")->load() == true;
+
+  if (shouldBakeEQ.load()) {
+    // go back to a plain IR as soon as the EQ moves
+    if (!isBakingEnabled || settings != bakedEQ) {
+      shouldBakeEQ.store(false);
+    }
+    return;
+  }
+
+  // bake the EQ once it has been static for a while, unless it's flat. A new
+  // baked IR is only requested once the convolver uses a plain one again, so
+  // that an installed baked IR always has the settings in bakedEQ
+  const bool isFlat =
+      settings.lowShelfGain == 0.0f && settings.highShelfGain == 0.0f;
+  if (isBakingEnabled && !isFlat &&
+      eqStaticSamples >= eqBakeDelay * getSampleRate() &&
+      !isBakedIRInstalled()) {
+    const juce::SpinLock::ScopedTryLockType lock(bakeRequestLock);
+    if (lock.isLocked()) {
+      requestedEQ = settings;
+      bakedEQ = settings;
+      shouldBakeEQ.store(true);
+    }
+  }
+}
+
+bool ConekoAudioProcessor::isBakedIRInstalled() {
+  // a resampled IR is baked if it was before the sample rate change, its
+  // length says nothing. Any other length means a rebuilt IR is installed
+  const int irSize = convolver.getCurrentIRSize();
+  const int resampledSize = resampledIRSize.load();
+  if (resampledSize > 0) {
+    if (irSize == resampledSize) {
+      return isResampledIRBaked;
+    }
+    resampledIRSize.store(0);
+  }
+  return isBakedIRLength(irSize);
+}
+
+void ConekoAudioProcessor::timerCallback() {
+  // stretching reloads the IR, baking the EQ into it if requested
+  if (isStretchPending.exchange(false)) {
+    updateIRParameters();
+  } else if (shouldBakeEQ.load() != isLoadedIRBaked) {
+    loadConvolverIR(modifiedIRBuffer);
+  }
+}
+
+double ConekoAudioProcessor::getHostBpm() {
+  if (auto *playHead = getPlayHead()) {
+    juce::AudioPlayHead::CurrentPositionInfo positionInfo;
+    if (playHead->getCurrentPosition(positionInfo) && positionInfo.bpm > 0.0) {
+      return positionInfo.bpm;
+    }
+  }
+  return 0.0;
+}
+
+int ConekoAudioProcessor::getDecaySixteenths(double decaySamples,
+                                             double bpm) const {
+  if (bpm <= 0.0 || decaySamples <= 0.0) {
+    return 0;
+  }
+  const double sixteenthSample = 60.0 / bpm / 4.0 * this->getSampleRate();
+  return juce::jmax(1, static_cast<int>(std::round(decaySamples /
+                                                   sixteenthSample)));
+}
+
+float ConekoAudioProcessor::getSyncedPreDelaySamples(double bpm,
+                                                     int divisionIndex) {
+  divisionIndex =
+      juce::jlimit(0, noteDivisionNames.size() - 1, divisionIndex);
+  const double preDelayTime = 60.0 / bpm * noteDivisionBeats[divisionIndex];
+  return static_cast<float>(std::min(preDelayTime, maxPreDelayTime) *
+                            this->getSampleRate());
+}
+
+void ConekoAudioProcessor::processStereoWidth(
+    juce::dsp::AudioBlock<float> &block) {
+  // nothing to do at the default width of 100%
+  if (!stereoWidth.isSmoothing() && stereoWidth.getTargetValue() == 1.0f) {
+    return;
+  }
+
+  // mid/side technique: with M = (L + R) / 2 and S = (L - R) / 2, the output
+  // is L = M + width * S and R = M - width * S. Expanded into a 2x2 matrix
+  // this is a single pass over both channels, which the compiler vectorises
+  const int numSamples = static_cast<int>(block.getNumSamples());
+  float *left = block.getChannelPointer(0);
+  float *right = block.getChannelPointer(1);
+  if (!stereoWidth.isSmoothing()) {
+    const float direct = (1.0f + stereoWidth.getTargetValue()) * 0.5f;
+    const float cross = (1.0f - stereoWidth.getTargetValue()) * 0.5f;
+    for (int sample = 0; sample < numSamples; ++sample) {
+      const float l = left[sample];
+      const float r = right[sample];
+      left[sample] = direct * l + cross * r;
+      right[sample] = cross * l + direct * r;
+    }
+    return;
+  }
+
+  const int chunkSize = rampBuffer.getNumSamples();
+  float *ramp = rampBuffer.getWritePointer(0);
+  for (int start = 0; start < numSamples && chunkSize > 0;
+       start += chunkSize) {
+    const int size = juce::jmin(chunkSize, numSamples - start);
+    if (!ParameterRamp::fill(stereoWidth, ramp, size)) {
+      juce::FloatVectorOperations::fill(ramp, stereoWidth.getTargetValue(),
+                                        size);
+    }
+    for (int sample = start; sample < start + size; ++sample) {
+      const float mid = (left[sample] + right[sample]) * 0.5f;
+      const float side =
+          (left[sample] - right[sample]) * 0.5f * ramp[sample - start];
+      left[sample] = mid + side;
+      right[sample] = mid - side;
+    }
+  }
 }
 
 juce::AudioProcessorValueTreeState::ParameterLayout
@@ -418,6 +942,15 @@ ConekoAudioProcessor::createParameters() {
       "DecayTime", "Decay", decayTimeRange, 3.0f));
   parameters.push_back(std::make_unique<juce::AudioParameterFloat>(
       "PreDelayTime", "Pre-delay", preDelayTimeRange, 0.0f));
+  parameters.push_back(std::make_unique<juce::AudioParameterBool>(
+      "PreDelaySync", "Pre-delay Sync", false));
+  parameters.push_back(std::make_unique<juce::AudioParameterChoice>(
+      "PreDelayDivision", "Pre-delay Note", noteDivisionNames,
+      noteDivisionNames.indexOf("1/16")));
+  parameters.push_back(std::make_unique<juce::AudioParameterBool>(
+      "DecaySync", "Decay Sync", false));
+  parameters.push_back(std::make_unique<juce::AudioParameterBool>(
+      "BakeEQ", "Bake EQ into IR", true));
   parameters.push_back(std::make_unique<juce::AudioParameterFloat>(
       "StereoWidth", "Width", stereoWidthRange, 100.0f));
   parameters.push_back(std::make_unique<juce::AudioParameterFloat>(
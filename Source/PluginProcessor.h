@@ -9,12 +9,18 @@
 #pragma once
 
 #include "../soundtouch/SoundTouch.h"
+#include "Equalizer.h"
+#include "IRAnalysis.h"
+#include "StageProfiler.h"
+#include "TempoDetector.h"
+#include "WaveformOverview.h"
 #include <JuceHeader.h>
 
 //==============================================================================
 /**
  */
-class ConekoAudioProcessor : public juce::AudioProcessor {
+class ConekoAudioProcessor : public juce::AudioProcessor,
+                             private juce::Timer {
 public:
   using APVTS = juce::AudioProcessorValueTreeState;
   //==============================================================================
@@ -66,28 +72,147 @@ public:
 
   void updateIRParameters();
   void updateFilterParameters();
+  const IRAnalysis::DecayAnalysis &getDecayAnalysis() const;
+  WaveformOverview &getWaveformOverview();
+  SampleFifo &getDryAnalyzerFifo();
+  SampleFifo &getWetAnalyzerFifo();
+  std::atomic<bool> &getAnalyzerActiveFlag();
+#if CONEKO_ENABLE_PROFILING
+  StageProfiler &getProfiler();
+#endif
+#if CONEKO_ENABLE_RT_TRACE
+  RealtimeTracer &getRealtimeTracer();
+#endif
+
+  static const juce::StringArray noteDivisionNames;
 
   APVTS apvts;
 
 private:
   juce::AudioBuffer<float> originalIRBuffer;
   juce::AudioBuffer<float> modifiedIRBuffer;
+  WaveformOverview waveformOverview;
 
   soundtouch::SoundTouch soundtouch;
 
+  // EDC level below the peak energy where loaded IRs are truncated
+  static constexpr float irTruncationLevel = -60.0f;
+  IRAnalysis::DecayAnalysis decayAnalysis;
+  // T60 of the loaded IR, the decay time it is stretched from
+  double measuredDecayTime = 0.0;
+
   APVTS::ParameterLayout createParameters();
 
+  struct EQSettings {
+    float lowShelfFreq = 20.0f;
+    float lowShelfGain = 0.0f;
+    float highShelfFreq = 20000.0f;
+    float highShelfGain = 0.0f;
+
+    bool operator==(const EQSettings &other) const;
+    bool operator!=(const EQSettings &other) const;
+  };
+  EQSettings getEQSettings();
+  void updateEQBaking(int numSamples);
+  void loadConvolverIR(juce::AudioBuffer<float> irBuffer);
+  static void bakeEQ(juce::AudioBuffer<float> &irBuffer,
+                     const EQSettings &settings, double sampleRate);
+  // The convolver doesn't report which IR it is using, so whether the EQ is
+  // baked into an IR is encoded in its length: baked IRs always have an odd
+  // number of samples, plain ones an even number. loadConvolverIR() pads
+  // the IRs to follow this rule. The one exception is an IR the convolver
+  // resampled itself after a sample rate change, see isBakedIRInstalled().
+  static bool isBakedIRLength(int numSamples) { return numSamples % 2 == 1; }
+  bool isBakedIRInstalled();
+
+  void timerCallback() override;
+  // tempo reported by the host, or 0 if it doesn't report one
+  double getHostBpm();
+  // length of a tempo synced decay in sixteenths, 0 without a tempo
+  int getDecaySixteenths(double decaySamples, double bpm) const;
+  float getSyncedPreDelaySamples(double bpm, int divisionIndex);
+  // processes at most the block size given to prepareToPlay
+  void processSubBlock(juce::AudioBuffer<float> &buffer,
+                       bool shouldFeedAnalyzer);
+  void processWetPath(juce::AudioBuffer<float> &buffer,
+                      bool shouldFeedAnalyzer);
+  void processStereoWidth(juce::dsp::AudioBlock<float> &block);
+  void mixDrySamples(juce::AudioBuffer<float> &buffer);
+  void crossfadeBypass(juce::AudioBuffer<float> &buffer);
+
+  // longest pre-delay in seconds, synced divisions at slow tempi included
+  static constexpr double maxPreDelayTime = 2.0;
+
+  TempoDetector tempoDetector;
+  // dry and wet signal for the editor's analyzer, fed only while it is active
+  SampleFifo dryAnalyzerFifo;
+  SampleFifo wetAnalyzerFifo;
+  std::atomic<bool> isAnalyzerActive{false};
+
+#if CONEKO_ENABLE_PROFILING
+  StageProfiler profiler;
+#endif
+#if CONEKO_ENABLE_RT_TRACE
+  RealtimeTracer realtimeTracer;
+#endif
+  // host tempo, or the detected one if the host doesn't report it
+  std::atomic<double> currentBpm{0.0};
+  juce::SmoothedValue<float> preDelaySamples;
+  juce::SmoothedValue<float> stereoWidth;
+  juce::SmoothedValue<float> wetMix;
+  // 1 while bypassed, fades the processed signal in and out
+  juce::SmoothedValue<float> bypassMix;
+  // per-sample values of whichever parameter is being ramped
+  juce::AudioBuffer<float> rampBuffer;
+  juce::AudioBuffer<float> dryBuffer;
+  // unprocessed input while fading in or out of the bypass
+  juce::AudioBuffer<float> bypassBuffer;
+  // set when the wet path was skipped, so that it restarts from silence
+  bool isWetPathIdle = false;
+  // samples processed at a mix of 0%, up to the length of the wet tail
+  int dryOnlySamples = 0;
+  // stretched IR length per second of decay time, 0 without an IR
+  std::atomic<double> irSamplesPerDecaySecond{0.0};
+  // sixteenths the IR was last stretched to, 0 if decay is not tempo synced
+  std::atomic<int> irDecaySixteenths{0};
+  // set by the audio thread, polled by the timer on the message thread
+  std::atomic<bool> isStretchPending{false};
+
+  // the EQ is baked into the IR once it has been static for this long, in
+  // seconds, and filtered live while it moves
+  static constexpr double eqBakeDelay = 0.5;
+  // set by the audio thread along with the settings to bake, polled by the
+  // timer on the message thread
+  std::atomic<bool> shouldBakeEQ{false};
+  juce::SpinLock bakeRequestLock;
+  EQSettings requestedEQ;
+  // message thread only: whether the IR last handed to the convolver is baked
+  bool isLoadedIRBaked = false;
+  // audio thread only: EQ of the last baked IR, and the settings of the
+  // previous block
+  EQSettings bakedEQ;
+  EQSettings previousEQ;
+  int eqStaticSamples = 0;
+  // length of the IR the convolver resampled on the last sample rate change,
+  // 0 once an IR loaded at the current rate is installed, and whether it was
+  // baked at the previous rate
+  std::atomic<int> resampledIRSize{0};
+  bool isResampledIRBaked = false;
+  double preparedSampleRate = 0.0;
+
   juce::dsp::Gain<float> inputGainer;
   juce::dsp::Gain<float> outputGainer;
-  juce::dsp::DryWetMixer<float> dryWetMixer;
   juce::dsp::DelayLine<float> delay;
   juce::dsp::Convolution convolver;
-  juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>,
-                                 juce::dsp::IIR::Coefficients<float>>
-      lowShelfFilter;
-  juce::dsp::ProcessorDuplicator<juce::dsp::IIR::Filter<float>,
-                                 juce::dsp::IIR::Coefficients<float>>
-      highShelfFilter;
+  // low and high shelf as the bands of a single EQ pass, and the inverse of
+  // the shelves baked into the IR for while those are being replaced
+  Equalizer equalizer{
+      Equalizer::BandType::lowShelf, Equalizer::BandType::highShelf,
+      Equalizer::BandType::lowShelf, Equalizer::BandType::highShelf};
+  static constexpr int lowShelfBand = 0;
+  static constexpr int highShelfBand = 1;
+  static constexpr int bakedLowShelfBand = 2;
+  static constexpr int bakedHighShelfBand = 3;
 
   //==============================================================================
   JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ConekoAudioProcessor)
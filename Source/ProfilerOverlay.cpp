@@ -0,0 +1,83 @@
+#include "ProfilerOverlay.h"
+
+#if CONEKO_ENABLE_PROFILING
+
+ProfilerOverlay::ProfilerOverlay(StageProfiler &profilerToShow)
+    : profiler(profilerToShow) {
+  addAndMakeVisible(resetButton);
+  resetButton.setButtonText("Reset");
+  resetButton.onClick = [this] { profiler.reset(); };
+
+  addAndMakeVisible(saveButton);
+  saveButton.setButtonText("Save CSV...");
+  saveButton.onClick = [this] { saveButtonClicked(); };
+
+  startTimerHz(4);
+}
+
+ProfilerOverlay::~ProfilerOverlay() { stopTimer(); }
+
+void ProfilerOverlay::timerCallback() {
+  for (int stage = 0; stage < StageProfiler::numStages; ++stage) {
+    stats[stage] = profiler.getStats(stage);
+  }
+  repaint();
+}
+
+void ProfilerOverlay::paint(juce::Graphics &g) {
+  g.fillAll(juce::Colour::fromRGB(252, 248, 237).withAlpha(0.9f));
+  g.setColour(juce::Colour::fromRGB(111, 76, 91));
+  g.setFont(10.0f);
+
+  const auto &blockStats = stats[StageProfiler::wholeBlock];
+  const int rowHeight = 9;
+  const int columnWidth = 90;
+  const char *const headers[] = {"Stage", "Mean us", "p99 us", "Max us",
+                                 "Block %"};
+  for (int column = 0; column < 5; ++column) {
+    g.drawText(headers[column], column * columnWidth, 0, columnWidth,
+               rowHeight, juce::Justification::centredLeft);
+  }
+
+  for (int stage = 0; stage < StageProfiler::numStages; ++stage) {
+    const auto &stageStats = stats[stage];
+    const double share =
+        blockStats.totalNanoseconds > 0
+            ? 100.0 * stageStats.totalNanoseconds / blockStats.totalNanoseconds
+            : 0.0;
+    const juce::String values[] = {
+        StageProfiler::getStageName(stage),
+        juce::String(stageStats.getMeanMicroseconds(), 1),
+        juce::String(stageStats.getPercentileMicroseconds(99.0), 1),
+        juce::String(stageStats.maxNanoseconds / 1000.0, 1),
+        juce::String(share, 1)};
+    for (int column = 0; column < 5; ++column) {
+      g.drawText(values[column], column * columnWidth,
+                 (stage + 1) * rowHeight, columnWidth, rowHeight,
+                 juce::Justification::centredLeft);
+    }
+  }
+}
+
+void ProfilerOverlay::resized() {
+  resetButton.setBounds(getWidth() - 90, 0, 90, 20);
+  saveButton.setBounds(getWidth() - 90, 25, 90, 20);
+}
+
+void ProfilerOverlay::saveButtonClicked() {
+  fileChooser = std::make_unique<juce::FileChooser>(
+      "Save stage timings as CSV...",
+      juce::File::getSpecialLocation(juce::File::userDocumentsDirectory)
+          .getChildFile("coneko-timings.csv"),
+      "*.csv", true, false);
+  auto chooserFlags = juce::FileBrowserComponent::saveMode |
+                      juce::FileBrowserComponent::warnAboutOverwriting;
+  fileChooser->launchAsync(chooserFlags, [this](const juce::FileChooser &fc) {
+    auto file = fc.getResult();
+    if (file != juce::File()) {
+      profiler.writeCSV(file);
+    }
+  });
+}
+
+#endif
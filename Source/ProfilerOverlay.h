@@ -0,0 +1,32 @@
+#pragma once
+
+#include "StageProfiler.h"
+#include <JuceHeader.h>
+
+#if CONEKO_ENABLE_PROFILING
+
+// Debug overlay listing the processing time of each stage of processBlock,
+// with buttons to reset the statistics and to dump them as CSV.
+class ProfilerOverlay : public juce::Component, private juce::Timer {
+public:
+  ProfilerOverlay(StageProfiler &profiler);
+  ~ProfilerOverlay() override;
+
+  void paint(juce::Graphics &) override;
+  void resized() override;
+
+private:
+  void timerCallback() override;
+  void saveButtonClicked();
+
+  StageProfiler &profiler;
+  std::array<StageProfiler::Stats, StageProfiler::numStages> stats;
+
+  juce::TextButton resetButton;
+  juce::TextButton saveButton;
+  std::unique_ptr<juce::FileChooser> fileChooser;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(ProfilerOverlay)
+};
+
+#endif
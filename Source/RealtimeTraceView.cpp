@@ -0,0 +1,56 @@
+#include "RealtimeTraceView.h"
+
+#if CONEKO_ENABLE_RT_TRACE
+
+RealtimeTraceView::RealtimeTraceView(RealtimeTracer &tracerToShow)
+    : tracer(tracerToShow) {
+  startTimerHz(4);
+}
+
+RealtimeTraceView::~RealtimeTraceView() { stopTimer(); }
+
+void RealtimeTraceView::timerCallback() {
+  int numRead;
+  while ((numRead = tracer.readEvents(readEvents.data(),
+                                      static_cast<int>(readEvents.size()))) >
+         0) {
+    for (int index = 0; index < numRead; ++index) {
+      const auto &event = readEvents[index];
+      juce::String text =
+          juce::String(RealtimeTracer::getEventTypeName(event.type)) + " in " +
+          event.stage;
+      if (event.type == RealtimeTracer::EventType::allocation) {
+        text << " (" << juce::String(event.value, 0) << " B)";
+      } else if (event.type == RealtimeTracer::EventType::deadlineMiss) {
+        text << " (" << juce::String(event.value, 2) << " ms)";
+      }
+      recentEvents.add(text);
+    }
+  }
+  recentEvents.removeRange(0, recentEvents.size() - numRecentEvents);
+  repaint();
+}
+
+void RealtimeTraceView::paint(juce::Graphics &g) {
+  g.fillAll(juce::Colour::fromRGB(252, 248, 237).withAlpha(0.9f));
+  g.setColour(juce::Colour::fromRGB(111, 76, 91));
+  g.setFont(10.0f);
+
+  const int rowHeight = 9;
+  juce::String totals;
+  const int numTypes = static_cast<int>(RealtimeTracer::EventType::numTypes);
+  for (int type = 0; type < numTypes; ++type) {
+    const auto eventType = static_cast<RealtimeTracer::EventType>(type);
+    totals << RealtimeTracer::getEventTypeName(eventType) << " "
+           << juce::String(tracer.getEventCount(eventType)) << "  ";
+  }
+  g.drawText(totals, 0, 0, getWidth(), rowHeight,
+             juce::Justification::centredLeft);
+
+  for (int row = 0; row < recentEvents.size(); ++row) {
+    g.drawText(recentEvents[row], 0, (row + 1) * rowHeight, getWidth(),
+               rowHeight, juce::Justification::centredLeft);
+  }
+}
+
+#endif
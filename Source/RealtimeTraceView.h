@@ -0,0 +1,29 @@
+#pragma once
+
+#include "RealtimeTracer.h"
+#include <JuceHeader.h>
+
+#if CONEKO_ENABLE_RT_TRACE
+
+// Debug view of the realtime-safety violations recorded by a RealtimeTracer:
+// totals per kind of violation and the most recent events.
+class RealtimeTraceView : public juce::Component, private juce::Timer {
+public:
+  RealtimeTraceView(RealtimeTracer &tracer);
+  ~RealtimeTraceView() override;
+
+  void paint(juce::Graphics &) override;
+
+private:
+  void timerCallback() override;
+
+  static constexpr int numRecentEvents = 7;
+
+  RealtimeTracer &tracer;
+  std::array<RealtimeTracer::Event, 64> readEvents;
+  juce::StringArray recentEvents;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(RealtimeTraceView)
+};
+
+#endif
@@ -0,0 +1,252 @@
+#include "RealtimeTracer.h"
+
+#if CONEKO_ENABLE_RT_TRACE
+
+#if JUCE_LINUX || JUCE_MAC
+#include <dlfcn.h>
+#include <pthread.h>
+#endif
+
+// state of the calling thread, constant initialised so that the hooks can
+// use it at any time
+static thread_local RealtimeTracer *activeTracer = nullptr;
+static thread_local const char *currentStage = "processBlock";
+static thread_local bool isRecording = false;
+
+RealtimeTracer::RealtimeSection::RealtimeSection(RealtimeTracer &tracerToUse,
+                                                 int numSamples,
+                                                 double sampleRate)
+    : tracer(tracerToUse), previousTracer(activeTracer),
+      deadlineMilliseconds(sampleRate > 0.0 ? 1000.0 * numSamples / sampleRate
+                                            : 0.0),
+      start(std::chrono::steady_clock::now()) {
+  currentStage = "processBlock";
+  activeTracer = &tracer;
+}
+
+RealtimeTracer::RealtimeSection::~RealtimeSection() {
+  const double elapsedMilliseconds =
+      std::chrono::duration<double, std::milli>(
+          std::chrono::steady_clock::now() - start)
+          .count();
+  if (deadlineMilliseconds > 0.0 &&
+      elapsedMilliseconds > deadlineMilliseconds) {
+    tracer.addEvent(EventType::deadlineMiss, "processBlock",
+                    elapsedMilliseconds);
+  }
+  activeTracer = previousTracer;
+}
+
+RealtimeTracer::ScopedStage::ScopedStage(const char *stage)
+    : previousStage(currentStage) {
+  currentStage = stage;
+}
+
+RealtimeTracer::ScopedStage::~ScopedStage() { currentStage = previousStage; }
+
+const char *RealtimeTracer::getEventTypeName(EventType type) {
+  switch (type) {
+  case EventType::allocation:
+    return "Alloc";
+  case EventType::deallocation:
+    return "Free";
+  case EventType::lock:
+    return "Lock";
+  case EventType::deadlineMiss:
+    return "Late";
+  default:
+    return "";
+  }
+}
+
+int RealtimeTracer::readEvents(Event *dest, int maxEvents) {
+  int start1, size1, start2, size2;
+  fifo.prepareToRead(maxEvents, start1, size1, start2, size2);
+  std::copy_n(events.begin() + start1, size1, dest);
+  std::copy_n(events.begin() + start2, size2, dest + size1);
+  fifo.finishedRead(size1 + size2);
+  return size1 + size2;
+}
+
+juce::uint64 RealtimeTracer::getEventCount(EventType type) const {
+  return eventCounts[static_cast<size_t>(type)].load(
+      std::memory_order_relaxed);
+}
+
+void RealtimeTracer::notifyAllocation(size_t numBytes) {
+  notifyActiveTracer(EventType::allocation, static_cast<double>(numBytes));
+}
+
+void RealtimeTracer::notifyDeallocation() {
+  notifyActiveTracer(EventType::deallocation, 0.0);
+}
+
+void RealtimeTracer::notifyLock() { notifyActiveTracer(EventType::lock, 0.0); }
+
+void RealtimeTracer::notifyActiveTracer(EventType type, double value) {
+  // the guard keeps anything the recording itself does from being recorded
+  if (activeTracer == nullptr || isRecording) {
+    return;
+  }
+  isRecording = true;
+  activeTracer->addEvent(type, currentStage, value);
+  isRecording = false;
+}
+
+void RealtimeTracer::addEvent(EventType type, const char *stage,
+                              double value) {
+  eventCounts[static_cast<size_t>(type)].fetch_add(1,
+                                                   std::memory_order_relaxed);
+
+  // the audio thread is the only writer; events that don't fit are dropped
+  int start1, size1, start2, size2;
+  fifo.prepareToWrite(1, start1, size1, start2, size2);
+  if (size1 > 0) {
+    events[start1] = {type, stage, value};
+    fifo.finishedWrite(1);
+  }
+}
+
+//==============================================================================
+// Hooks, these replace the global allocation functions of the plugin module.
+// The standard libraries don't implement the nothrow and aligned variants
+// in terms of the plain ones, so each variant is replaced explicitly.
+
+void *operator new(std::size_t size) {
+  RealtimeTracer::notifyAllocation(size);
+  if (void *ptr = std::malloc(size == 0 ? 1 : size)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size) { return ::operator new(size); }
+
+void operator delete(void *ptr) noexcept {
+  if (ptr != nullptr) {
+    RealtimeTracer::notifyDeallocation();
+    std::free(ptr);
+  }
+}
+
+void operator delete[](void *ptr) noexcept { ::operator delete(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept {
+  ::operator delete(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+  ::operator delete(ptr);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+  RealtimeTracer::notifyAllocation(size);
+  return std::malloc(size == 0 ? 1 : size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &tag) noexcept {
+  return ::operator new(size, tag);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+  ::operator delete(ptr);
+}
+
+void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+  ::operator delete(ptr);
+}
+
+#if __cpp_aligned_new
+static void *allocateAligned(std::size_t size, std::align_val_t alignment) {
+  RealtimeTracer::notifyAllocation(size);
+  const auto align = juce::jmax(static_cast<std::size_t>(alignment),
+                                sizeof(void *));
+#if JUCE_WINDOWS
+  return _aligned_malloc(size == 0 ? 1 : size, align);
+#else
+  void *ptr = nullptr;
+  return posix_memalign(&ptr, align, size == 0 ? 1 : size) == 0 ? ptr
+                                                                : nullptr;
+#endif
+}
+
+static void freeAligned(void *ptr) {
+  if (ptr != nullptr) {
+    RealtimeTracer::notifyDeallocation();
+#if JUCE_WINDOWS
+    _aligned_free(ptr);
+#else
+    std::free(ptr);
+#endif
+  }
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment) {
+  if (void *ptr = allocateAligned(size, alignment)) {
+    return ptr;
+  }
+  throw std::bad_alloc();
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment) {
+  return ::operator new(size, alignment);
+}
+
+void *operator new(std::size_t size, std::align_val_t alignment,
+                   const std::nothrow_t &) noexcept {
+  return allocateAligned(size, alignment);
+}
+
+void *operator new[](std::size_t size, std::align_val_t alignment,
+                     const std::nothrow_t &) noexcept {
+  return allocateAligned(size, alignment);
+}
+
+void operator delete(void *ptr, std::align_val_t) noexcept {
+  freeAligned(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t) noexcept {
+  freeAligned(ptr);
+}
+
+void operator delete(void *ptr, std::size_t, std::align_val_t) noexcept {
+  freeAligned(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t, std::align_val_t) noexcept {
+  freeAligned(ptr);
+}
+
+void operator delete(void *ptr, std::align_val_t,
+                     const std::nothrow_t &) noexcept {
+  freeAligned(ptr);
+}
+
+void operator delete[](void *ptr, std::align_val_t,
+                       const std::nothrow_t &) noexcept {
+  freeAligned(ptr);
+}
+#endif
+
+#if JUCE_LINUX || JUCE_MAC
+// Mutex locks are caught by interposing pthread_mutex_lock, which covers
+// juce::CriticalSection and std::mutex of this module. Windows has no
+// equivalent hook, so locks aren't traced there.
+extern "C" int pthread_mutex_lock(pthread_mutex_t *mutex) {
+  using LockFunction = int (*)(pthread_mutex_t *);
+  static std::atomic<LockFunction> realLock{nullptr};
+
+  auto lockFunction = realLock.load(std::memory_order_relaxed);
+  if (lockFunction == nullptr) {
+    lockFunction = reinterpret_cast<LockFunction>(
+        dlsym(RTLD_NEXT, "pthread_mutex_lock"));
+    realLock.store(lockFunction, std::memory_order_relaxed);
+  }
+
+  RealtimeTracer::notifyLock();
+  return lockFunction(mutex);
+}
+#endif
+
+#endif
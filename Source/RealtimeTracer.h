@@ -0,0 +1,101 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Realtime-safety tracing of processBlock. Enabled in debug builds by
+// default; it replaces the global operator new and delete of the plugin, so
+// it is never compiled into release builds unless explicitly requested.
+#ifndef CONEKO_ENABLE_RT_TRACE
+#if JUCE_DEBUG
+#define CONEKO_ENABLE_RT_TRACE 1
+#else
+#define CONEKO_ENABLE_RT_TRACE 0
+#endif
+#endif
+
+#if CONEKO_ENABLE_RT_TRACE
+
+// While a RealtimeSection is active on a thread, heap allocations, frees and
+// mutex locks made by that thread are recorded, as are blocks that take
+// longer than their real-time deadline. Events are tagged with the current
+// stage and collected in a lock-free log that the UI drains.
+class RealtimeTracer {
+public:
+  enum class EventType {
+    allocation,
+    deallocation,
+    lock,
+    deadlineMiss,
+    numTypes
+  };
+
+  struct Event {
+    EventType type = EventType::allocation;
+    const char *stage = "";
+    // bytes for allocations, milliseconds for deadline misses
+    double value = 0.0;
+  };
+
+  // marks the processing of one block on the current thread
+  class RealtimeSection {
+  public:
+    RealtimeSection(RealtimeTracer &tracerToUse, int numSamples,
+                    double sampleRate);
+    ~RealtimeSection();
+
+  private:
+    RealtimeTracer &tracer;
+    RealtimeTracer *previousTracer;
+    double deadlineMilliseconds;
+    std::chrono::steady_clock::time_point start;
+  };
+
+  // tags the events of the current thread with a stage name
+  class ScopedStage {
+  public:
+    explicit ScopedStage(const char *stage);
+    ~ScopedStage();
+
+  private:
+    const char *previousStage;
+  };
+
+  RealtimeTracer() = default;
+
+  static const char *getEventTypeName(EventType type);
+
+  // consumer side, returns the number of events copied to 'dest'
+  int readEvents(Event *dest, int maxEvents);
+  // events recorded so far, including those that didn't fit into the log
+  juce::uint64 getEventCount(EventType type) const;
+
+  // called from the hooks, record an event if a realtime section is active
+  // on the calling thread
+  static void notifyAllocation(size_t numBytes);
+  static void notifyDeallocation();
+  static void notifyLock();
+
+private:
+  static void notifyActiveTracer(EventType type, double value);
+  void addEvent(EventType type, const char *stage, double value);
+
+  static constexpr int logSize = 256;
+  juce::AbstractFifo fifo{logSize};
+  std::array<Event, logSize> events;
+  std::array<std::atomic<juce::uint64>,
+             static_cast<size_t>(EventType::numTypes)>
+      eventCounts{};
+};
+
+#define CONEKO_TRACE_BLOCK(tracer, numSamples, sampleRate)                     \
+  RealtimeTracer::RealtimeSection realtimeSection(tracer, numSamples,          \
+                                                  sampleRate)
+#define CONEKO_TRACE_STAGE(stage)                                              \
+  RealtimeTracer::ScopedStage JUCE_JOIN_MACRO(traceStage, __LINE__)(#stage)
+
+#else
+
+#define CONEKO_TRACE_BLOCK(tracer, numSamples, sampleRate)
+#define CONEKO_TRACE_STAGE(stage)
+
+#endif
@@ -0,0 +1,52 @@
+#include "SampleFifo.h"
+
+void SampleFifo::prepare(int capacity) {
+  fifo.setTotalSize(capacity);
+  fifo.reset();
+  buffer.assign(capacity, 0.0f);
+}
+
+void SampleFifo::push(const float *const *channelData, int numChannels,
+                      int numSamples) {
+  if (numChannels < 1 || buffer.empty()) {
+    return;
+  }
+
+  int start1, size1, start2, size2;
+  fifo.prepareToWrite(numSamples, start1, size1, start2, size2);
+
+  const float channelGain = 1.0f / numChannels;
+  auto mixDown = [&](int fifoStart, int sourceStart, int size) {
+    float *dest = buffer.data() + fifoStart;
+    juce::FloatVectorOperations::copyWithMultiply(
+        dest, channelData[0] + sourceStart, channelGain, size);
+    for (int channel = 1; channel < numChannels; ++channel) {
+      juce::FloatVectorOperations::addWithMultiply(
+          dest, channelData[channel] + sourceStart, channelGain, size);
+    }
+  };
+  if (size1 > 0) {
+    mixDown(start1, 0, size1);
+  }
+  if (size2 > 0) {
+    mixDown(start2, size1, size2);
+  }
+  fifo.finishedWrite(size1 + size2);
+}
+
+int SampleFifo::pop(float *dest, int maxSamples) {
+  int start1, size1, start2, size2;
+  fifo.prepareToRead(maxSamples, start1, size1, start2, size2);
+  if (size1 > 0) {
+    std::copy_n(buffer.data() + start1, size1, dest);
+  }
+  if (size2 > 0) {
+    std::copy_n(buffer.data() + start2, size2, dest + size1);
+  }
+  fifo.finishedRead(size1 + size2);
+  return size1 + size2;
+}
+
+int SampleFifo::getNumReady() const { return fifo.getNumReady(); }
+
+int SampleFifo::getCapacity() const { return static_cast<int>(buffer.size()); }
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Wait-free single producer, single consumer ring buffer of mono samples for
+// handing audio from the audio thread to an analysis thread. The producer
+// never allocates or blocks; samples that don't fit are dropped.
+class SampleFifo {
+public:
+  SampleFifo() = default;
+
+  // allocates the buffer, must not be called while either side is running
+  void prepare(int capacity);
+
+  // producer side, mixes the channels down to mono
+  void push(const float *const *channelData, int numChannels, int numSamples);
+
+  // consumer side, returns the number of samples copied to 'dest'
+  int pop(float *dest, int maxSamples);
+  int getNumReady() const;
+  int getCapacity() const;
+
+private:
+  juce::AbstractFifo fifo{1};
+  std::vector<float> buffer;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SampleFifo)
+};
@@ -0,0 +1,102 @@
+#include "SignalAnalyzer.h"
+
+// floor of the displayed levels
+static const float minDecibels = -96.0f;
+
+SignalAnalyzer::SignalAnalyzer(SampleFifo &dryFifoToRead,
+                               SampleFifo &wetFifoToRead,
+                               std::atomic<bool> &activeFlag)
+    : juce::Thread("Coneko Signal Analyzer"), dryFifo(dryFifoToRead),
+      wetFifo(wetFifoToRead), isActive(activeFlag) {
+  readBuffer.resize(juce::jmax(dryFifo.getCapacity(), wetFifo.getCapacity()));
+  dryWindow.assign(fftSize, 0.0f);
+  wetWindow.assign(fftSize, 0.0f);
+  fftData.assign(fftSize * 2, 0.0f);
+  workFrame.drySpectrum.fill(minDecibels);
+  workFrame.wetSpectrum.fill(minDecibels);
+  workFrame.wetLevelHistory.fill(minDecibels);
+  frame = workFrame;
+
+  // drop whatever was left from a previous analyzer before feeding resumes
+  dryFifo.pop(readBuffer.data(), dryFifo.getNumReady());
+  wetFifo.pop(readBuffer.data(), wetFifo.getNumReady());
+  isActive.store(true);
+  startThread();
+}
+
+SignalAnalyzer::~SignalAnalyzer() {
+  isActive.store(false);
+  stopThread(1000);
+}
+
+void SignalAnalyzer::getFrame(Frame &destFrame) const {
+  const juce::SpinLock::ScopedLockType sl(frameLock);
+  destFrame = frame;
+}
+
+void SignalAnalyzer::run() {
+  const int frameInterval = 1000 / frameRate;
+
+  while (!threadShouldExit()) {
+    const auto frameStart = juce::Time::getMillisecondCounter();
+
+    double drySumSquares = 0.0, wetSumSquares = 0.0;
+    int dryNumRead = 0, wetNumRead = 0;
+    readFifo(dryFifo, dryWindow, drySumSquares, dryNumRead);
+    readFifo(wetFifo, wetWindow, wetSumSquares, wetNumRead);
+
+    if (dryNumRead > 0 || wetNumRead > 0) {
+      updateSpectrum(dryWindow, workFrame.drySpectrum);
+      updateSpectrum(wetWindow, workFrame.wetSpectrum);
+
+      // scroll the wet level history by one frame
+      auto &history = workFrame.wetLevelHistory;
+      std::rotate(history.begin(), history.begin() + 1, history.end());
+      history.back() =
+          wetNumRead > 0
+              ? juce::Decibels::gainToDecibels(
+                    static_cast<float>(std::sqrt(wetSumSquares / wetNumRead)),
+                    minDecibels)
+              : minDecibels;
+
+      const juce::SpinLock::ScopedLockType sl(frameLock);
+      frame = workFrame;
+    }
+
+    const auto elapsed = juce::Time::getMillisecondCounter() - frameStart;
+    wait(juce::jmax(1, frameInterval - static_cast<int>(elapsed)));
+  }
+}
+
+void SignalAnalyzer::readFifo(SampleFifo &fifo, std::vector<float> &window,
+                              double &sumSquares, int &numRead) {
+  numRead = fifo.pop(readBuffer.data(), fifo.getNumReady());
+  for (int sample = 0; sample < numRead; ++sample) {
+    sumSquares += readBuffer[sample] * readBuffer[sample];
+  }
+
+  // keep the latest fftSize samples in the window
+  if (numRead >= fftSize) {
+    std::copy_n(readBuffer.data() + numRead - fftSize, fftSize, window.data());
+  } else if (numRead > 0) {
+    std::copy(window.begin() + numRead, window.end(), window.begin());
+    std::copy_n(readBuffer.data(), numRead, window.data() + fftSize - numRead);
+  }
+}
+
+void SignalAnalyzer::updateSpectrum(const std::vector<float> &window,
+                                    std::array<float, numBins> &spectrum) {
+  std::fill(fftData.begin(), fftData.end(), 0.0f);
+  std::copy(window.begin(), window.end(), fftData.begin());
+  windowing.multiplyWithWindowingTable(fftData.data(), fftSize);
+  fft.performFrequencyOnlyForwardTransform(fftData.data());
+
+  // a full scale sine gives fftSize / 4 with the Hann window; let the display
+  // fall back slowly so that it doesn't flicker
+  const float gainToFullScale = 4.0f / fftSize;
+  for (int bin = 0; bin < numBins; ++bin) {
+    const float level = juce::Decibels::gainToDecibels(
+        fftData[bin] * gainToFullScale, minDecibels);
+    spectrum[bin] = juce::jmax(level, spectrum[bin] - 1.5f);
+  }
+}
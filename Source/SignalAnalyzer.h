@@ -0,0 +1,57 @@
+#pragma once
+
+#include "SampleFifo.h"
+#include <JuceHeader.h>
+
+// Reads the dry and wet signal from the processor's analyzer FIFOs on a
+// background thread, and computes their spectra and a history of the wet
+// level at a capped frame rate. The processor only feeds the FIFOs while an
+// analyzer exists, so it costs nothing while the editor is closed.
+class SignalAnalyzer : private juce::Thread {
+public:
+  static constexpr int fftOrder = 11;
+  static constexpr int fftSize = 1 << fftOrder;
+  static constexpr int numBins = fftSize / 2;
+  static constexpr int historySize = 128;
+  static constexpr int frameRate = 30;
+
+  struct Frame {
+    // magnitudes in dB relative to full scale
+    std::array<float, numBins> drySpectrum;
+    std::array<float, numBins> wetSpectrum;
+    // wet RMS level in dB per frame, oldest first
+    std::array<float, historySize> wetLevelHistory;
+  };
+
+  SignalAnalyzer(SampleFifo &dryFifoToRead, SampleFifo &wetFifoToRead,
+                 std::atomic<bool> &activeFlag);
+  ~SignalAnalyzer() override;
+
+  // copies the latest frame
+  void getFrame(Frame &destFrame) const;
+
+private:
+  void run() override;
+  void readFifo(SampleFifo &fifo, std::vector<float> &window,
+                double &sumSquares, int &numRead);
+  void updateSpectrum(const std::vector<float> &window,
+                      std::array<float, numBins> &spectrum);
+
+  SampleFifo &dryFifo;
+  SampleFifo &wetFifo;
+  std::atomic<bool> &isActive;
+
+  juce::dsp::FFT fft{fftOrder};
+  juce::dsp::WindowingFunction<float> windowing{
+      fftSize, juce::dsp::WindowingFunction<float>::hann};
+  std::vector<float> readBuffer;
+  std::vector<float> dryWindow;
+  std::vector<float> wetWindow;
+  std::vector<float> fftData;
+  Frame workFrame;
+
+  mutable juce::SpinLock frameLock;
+  Frame frame;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(SignalAnalyzer)
+};
@@ -0,0 +1,119 @@
+#include "StageProfiler.h"
+
+#if CONEKO_ENABLE_PROFILING
+
+double StageProfiler::Stats::getMeanMicroseconds() const {
+  return count > 0 ? totalNanoseconds / 1000.0 / count : 0.0;
+}
+
+double StageProfiler::Stats::getPercentileMicroseconds(
+    double percentile) const {
+  const double target = count * percentile / 100.0;
+  juce::uint64 accumulated = 0;
+  for (int bin = 0; bin < numHistogramBins; ++bin) {
+    accumulated += histogram[bin];
+    if (accumulated >= target && accumulated > 0) {
+      return std::ldexp(1.0, bin) / 1000.0;
+    }
+  }
+  return maxNanoseconds / 1000.0;
+}
+
+StageProfiler::ScopedTimer::ScopedTimer(StageProfiler &profilerToUse,
+                                        Stage stageToTime)
+    : profiler(profilerToUse), stage(stageToTime),
+      start(std::chrono::steady_clock::now()) {}
+
+StageProfiler::ScopedTimer::~ScopedTimer() {
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  profiler.record(
+      stage,
+      static_cast<juce::uint64>(
+          std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed)
+              .count()));
+}
+
+const char *StageProfiler::getStageName(int stage) {
+  static const char *const names[] = {
+      "Input gain", "Convolution", "Pre-delay",   "Width",
+      "Equalizer",  "Dry/wet mix", "Output gain", "Whole block"};
+  return juce::isPositiveAndBelow(stage, static_cast<int>(numStages))
+             ? names[stage]
+             : "";
+}
+
+void StageProfiler::record(Stage stage, juce::uint64 nanoseconds) {
+  auto &stageCounters = counters[stage];
+  stageCounters.count.fetch_add(1, std::memory_order_relaxed);
+  stageCounters.totalNanoseconds.fetch_add(nanoseconds,
+                                           std::memory_order_relaxed);
+
+  // only the audio thread writes, so a plain compare is enough for the max
+  if (nanoseconds >
+      stageCounters.maxNanoseconds.load(std::memory_order_relaxed)) {
+    stageCounters.maxNanoseconds.store(nanoseconds, std::memory_order_relaxed);
+  }
+
+  int bin = 0;
+  if (nanoseconds > 0) {
+    const auto clamped = static_cast<juce::uint32>(
+        juce::jmin<juce::uint64>(nanoseconds, 0xffffffff));
+    bin = juce::jmin(numHistogramBins - 1,
+                     juce::findHighestSetBit(clamped) + 1);
+  }
+  stageCounters.histogram[bin].fetch_add(1, std::memory_order_relaxed);
+}
+
+StageProfiler::Stats StageProfiler::getStats(int stage) const {
+  Stats stats;
+  if (!juce::isPositiveAndBelow(stage, static_cast<int>(numStages))) {
+    return stats;
+  }
+
+  const auto &stageCounters = counters[stage];
+  stats.count = stageCounters.count.load(std::memory_order_relaxed);
+  stats.totalNanoseconds =
+      stageCounters.totalNanoseconds.load(std::memory_order_relaxed);
+  stats.maxNanoseconds =
+      stageCounters.maxNanoseconds.load(std::memory_order_relaxed);
+  for (int bin = 0; bin < numHistogramBins; ++bin) {
+    stats.histogram[bin] =
+        stageCounters.histogram[bin].load(std::memory_order_relaxed);
+  }
+  return stats;
+}
+
+void StageProfiler::reset() {
+  for (auto &stageCounters : counters) {
+    stageCounters.count.store(0, std::memory_order_relaxed);
+    stageCounters.totalNanoseconds.store(0, std::memory_order_relaxed);
+    stageCounters.maxNanoseconds.store(0, std::memory_order_relaxed);
+    for (auto &binCount : stageCounters.histogram) {
+      binCount.store(0, std::memory_order_relaxed);
+    }
+  }
+}
+
+bool StageProfiler::writeCSV(const juce::File &file) const {
+  juce::String csv = "stage,count,mean_us,p50_us,p99_us,max_us";
+  for (int bin = 0; bin < numHistogramBins; ++bin) {
+    csv << ",le_" << juce::String(std::ldexp(1.0, bin) / 1000.0) << "us";
+  }
+  csv << "\n";
+
+  for (int stage = 0; stage < numStages; ++stage) {
+    const auto stats = getStats(stage);
+    csv << getStageName(stage) << "," << juce::String(stats.count) << ","
+        << juce::String(stats.getMeanMicroseconds(), 3) << ","
+        << juce::String(stats.getPercentileMicroseconds(50.0), 3) << ","
+        << juce::String(stats.getPercentileMicroseconds(99.0), 3) << ","
+        << juce::String(stats.maxNanoseconds / 1000.0, 3);
+    for (int bin = 0; bin < numHistogramBins; ++bin) {
+      csv << "," << juce::String(stats.histogram[bin]);
+    }
+    csv << "\n";
+  }
+  return file.replaceWithText(csv);
+}
+
+#endif
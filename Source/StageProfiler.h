@@ -0,0 +1,94 @@
+#pragma once
+
+#include "RealtimeTracer.h"
+#include <JuceHeader.h>
+
+// Per-stage timing of processBlock. Enabled in debug builds by default; when
+// disabled, the profiler, its overlay and all timing points compile away.
+#ifndef CONEKO_ENABLE_PROFILING
+#if JUCE_DEBUG
+#define CONEKO_ENABLE_PROFILING 1
+#else
+#define CONEKO_ENABLE_PROFILING 0
+#endif
+#endif
+
+#if CONEKO_ENABLE_PROFILING
+
+// Accumulates the time spent in each processing stage into lock-free
+// histograms. The audio thread only does relaxed atomic increments, readers
+// may take a snapshot at any time.
+class StageProfiler {
+public:
+  enum Stage {
+    inputGain,
+    convolution,
+    preDelay,
+    stereoWidth,
+    equalizer,
+    dryWetMix,
+    outputGain,
+    wholeBlock,
+    numStages
+  };
+
+  // bin n counts durations from 2^(n-1) up to 2^n nanoseconds
+  static constexpr int numHistogramBins = 32;
+
+  struct Stats {
+    juce::uint64 count = 0;
+    juce::uint64 totalNanoseconds = 0;
+    juce::uint64 maxNanoseconds = 0;
+    std::array<juce::uint64, numHistogramBins> histogram{};
+
+    double getMeanMicroseconds() const;
+    // upper bound of the histogram bin containing the given percentile
+    double getPercentileMicroseconds(double percentile) const;
+  };
+
+  // measures the lifetime of the object as one run of a stage
+  class ScopedTimer {
+  public:
+    ScopedTimer(StageProfiler &profilerToUse, Stage stageToTime);
+    ~ScopedTimer();
+
+  private:
+    StageProfiler &profiler;
+    Stage stage;
+    std::chrono::steady_clock::time_point start;
+  };
+
+  static const char *getStageName(int stage);
+
+  void record(Stage stage, juce::uint64 nanoseconds);
+  Stats getStats(int stage) const;
+  void reset();
+
+  // writes the statistics and histograms of all stages as CSV
+  bool writeCSV(const juce::File &file) const;
+
+private:
+  struct StageCounters {
+    std::atomic<juce::uint64> count{0};
+    std::atomic<juce::uint64> totalNanoseconds{0};
+    std::atomic<juce::uint64> maxNanoseconds{0};
+    std::array<std::atomic<juce::uint64>, numHistogramBins> histogram{};
+  };
+
+  std::array<StageCounters, numStages> counters;
+};
+
+#define CONEKO_PROFILE_TIMER(profiler, stage)                                  \
+  StageProfiler::ScopedTimer JUCE_JOIN_MACRO(stageTimer, __LINE__)(            \
+      profiler, StageProfiler::stage)
+
+#else
+
+#define CONEKO_PROFILE_TIMER(profiler, stage)
+
+#endif
+
+// marks a stage of processBlock for both the profiler and the realtime tracer
+#define CONEKO_PROFILE_STAGE(profiler, stage)                                  \
+  CONEKO_PROFILE_TIMER(profiler, stage);                                       \
+  CONEKO_TRACE_STAGE(stage)
@@ -0,0 +1,57 @@
+#include "TempoDetector.h"
+
+TempoDetector::TempoDetector() : juce::Thread("Coneko Tempo Detector") {}
+
+TempoDetector::~TempoDetector() { stop(); }
+
+void TempoDetector::prepare(double sampleRate) {
+  stop();
+
+  // buffer a few seconds of input so that the detector can lag behind
+  const int fifoSize = static_cast<int>(sampleRate * 4.0);
+  fifo.prepare(fifoSize);
+  workBuffer.assign(fifoSize, 0.0f);
+
+  detector = std::make_unique<soundtouch::BPMDetect>(
+      1, static_cast<int>(sampleRate));
+  detectInterval = static_cast<int>(sampleRate * 2.0);
+  detectedBpm.store(0.0f);
+
+  startThread();
+}
+
+void TempoDetector::stop() { stopThread(1000); }
+
+void TempoDetector::pushSamples(const juce::AudioBuffer<float> &buffer) {
+  // the detector doesn't benefit from separate channels
+  fifo.push(buffer.getArrayOfReadPointers(), buffer.getNumChannels(),
+            buffer.getNumSamples());
+}
+
+float TempoDetector::getBpm() const { return detectedBpm.load(); }
+
+void TempoDetector::run() {
+  int samplesSinceDetect = 0;
+
+  while (!threadShouldExit()) {
+    const int numRead =
+        fifo.pop(workBuffer.data(), static_cast<int>(workBuffer.size()));
+    if (numRead > 0) {
+      detector->inputSamples(workBuffer.data(), numRead);
+      samplesSinceDetect += numRead;
+    }
+
+    // the autocorrelation decays over time, so re-reading the peak every few
+    // seconds follows tempo changes of the input. Keep the previous estimate
+    // when detection fails, e.g. during silence
+    if (samplesSinceDetect >= detectInterval) {
+      const float bpm = detector->getBpm();
+      if (bpm > 0.0f) {
+        detectedBpm.store(bpm);
+      }
+      samplesSinceDetect = 0;
+    }
+
+    wait(50);
+  }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "../soundtouch/BPMDetect.h"
+#include "SampleFifo.h"
+#include <JuceHeader.h>
+
+// Estimates the tempo of the plugin input on a background thread, for hosts
+// that don't report one through the playhead. The audio thread only mixes the
+// input down into a lock-free FIFO; BPMDetect runs on the analysis thread.
+class TempoDetector : private juce::Thread {
+public:
+  TempoDetector();
+  ~TempoDetector() override;
+
+  void prepare(double sampleRate);
+  void stop();
+
+  // called from the audio thread, drops samples if the analysis falls behind
+  void pushSamples(const juce::AudioBuffer<float> &buffer);
+
+  // last detected tempo in BPM, or 0 if none has been detected yet
+  float getBpm() const;
+
+private:
+  void run() override;
+
+  std::unique_ptr<soundtouch::BPMDetect> detector;
+  SampleFifo fifo;
+  std::vector<float> workBuffer;
+  int detectInterval = 0;
+  std::atomic<float> detectedBpm{0.0f};
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(TempoDetector)
+};
@@ -0,0 +1,80 @@
+#include "WaveformDisplay.h"
+
+WaveformDisplay::WaveformDisplay(WaveformOverview &overview)
+    : waveformOverview(overview) {
+  // the cached image covers the whole component, so nothing behind it needs
+  // repainting
+  setOpaque(true);
+  waveformOverview.addChangeListener(this);
+}
+
+WaveformDisplay::~WaveformDisplay() {
+  waveformOverview.removeChangeListener(this);
+}
+
+void WaveformDisplay::paint(juce::Graphics &g) {
+  const float scale = g.getInternalContext().getPhysicalPixelScaleFactor();
+  const int imageWidth = juce::jmax(1, juce::roundToInt(getWidth() * scale));
+  const int imageHeight = juce::jmax(1, juce::roundToInt(getHeight() * scale));
+  if (!isImageValid || waveformImage.getWidth() != imageWidth ||
+      waveformImage.getHeight() != imageHeight) {
+    renderWaveform(scale);
+  }
+  g.drawImage(waveformImage, getLocalBounds().toFloat());
+}
+
+void WaveformDisplay::resized() { isImageValid = false; }
+
+void WaveformDisplay::changeListenerCallback(juce::ChangeBroadcaster *source) {
+  // a new waveform overview has been built for the current IR
+  isImageValid = false;
+  repaint();
+}
+
+void WaveformDisplay::renderWaveform(float scale) {
+  const int imageWidth = juce::jmax(1, juce::roundToInt(getWidth() * scale));
+  const int imageHeight = juce::jmax(1, juce::roundToInt(getHeight() * scale));
+  if (waveformImage.getWidth() != imageWidth ||
+      waveformImage.getHeight() != imageHeight) {
+    waveformImage = juce::Image(juce::Image::RGB, imageWidth, imageHeight,
+                                false);
+  }
+  isImageValid = true;
+
+  juce::Graphics g(waveformImage);
+  g.fillAll(juce::Colour::fromRGB(252, 248, 237));
+
+  auto pyramid = waveformOverview.getPyramid();
+  if (pyramid == nullptr || pyramid->getNumSamples() < 1) {
+    return;
+  }
+
+  const juce::int64 numSamples = pyramid->getNumSamples();
+  const float top = 0.5f * scale;
+  const float bottom = imageHeight - 0.5f * scale;
+
+  // one pyramid lookup per pixel column, the paths keep their storage
+  waveformPath.clear();
+  waveformPath.startNewSubPath(0, bottom);
+  waveformRMSPath.clear();
+  waveformRMSPath.startNewSubPath(0, bottom);
+  for (int xPos = 0; xPos < imageWidth; ++xPos) {
+    auto bin = pyramid->getRange(xPos * numSamples / imageWidth,
+                                 (xPos + 1) * numSamples / imageWidth);
+    auto yPos = juce::jmap<float>(
+        juce::Decibels::gainToDecibels<float>(bin.getPeak(), -72.0f), -72.0f,
+        0.0f, bottom, top);
+    waveformPath.lineTo(xPos, yPos);
+    auto rmsYPos = juce::jmap<float>(
+        juce::Decibels::gainToDecibels<float>(bin.getRMS(), -72.0f), -72.0f,
+        0.0f, bottom, top);
+    waveformRMSPath.lineTo(xPos, rmsYPos);
+  }
+  waveformRMSPath.lineTo(imageWidth - 1, bottom);
+  waveformRMSPath.closeSubPath();
+
+  g.setColour(juce::Colour::fromRGB(158, 119, 119));
+  g.strokePath(waveformPath, juce::PathStrokeType(scale));
+  g.setColour(juce::Colour::fromRGB(158, 119, 119).withAlpha(0.3f));
+  g.fillPath(waveformRMSPath);
+}
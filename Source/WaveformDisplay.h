@@ -0,0 +1,30 @@
+#pragma once
+
+#include "WaveformOverview.h"
+#include <JuceHeader.h>
+
+// Shows the IR waveform from a WaveformOverview. The waveform is rendered
+// into a cached image that is only redrawn when a new overview is published
+// or the size changes, so repaints caused by neighbouring controls just blit
+// the image.
+class WaveformDisplay : public juce::Component, private juce::ChangeListener {
+public:
+  WaveformDisplay(WaveformOverview &overview);
+  ~WaveformDisplay() override;
+
+  void paint(juce::Graphics &) override;
+  void resized() override;
+
+private:
+  void changeListenerCallback(juce::ChangeBroadcaster *source) override;
+  void renderWaveform(float scale);
+
+  WaveformOverview &waveformOverview;
+
+  juce::Image waveformImage;
+  bool isImageValid = false;
+  juce::Path waveformPath;
+  juce::Path waveformRMSPath;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformDisplay)
+};
@@ -0,0 +1,144 @@
+#include "WaveformOverview.h"
+
+float WaveformOverview::Bin::getRMS() const {
+  return numSamples > 0 ? std::sqrt(sumSquares / numSamples) : 0.0f;
+}
+
+void WaveformOverview::Bin::merge(const Bin &other) {
+  if (other.numSamples == 0) {
+    return;
+  }
+  if (numSamples == 0) {
+    *this = other;
+    return;
+  }
+  min = juce::jmin(min, other.min);
+  max = juce::jmax(max, other.max);
+  sumSquares += other.sumSquares;
+  numSamples += other.numSamples;
+}
+
+WaveformOverview::Bin
+WaveformOverview::Pyramid::getRange(juce::int64 startSample,
+                                    juce::int64 endSample) const {
+  Bin result;
+  if (levels.empty()) {
+    return result;
+  }
+  startSample = juce::jlimit<juce::int64>(0, numSamples - 1, startSample);
+  endSample = juce::jlimit<juce::int64>(startSample + 1, numSamples, endSample);
+
+  // cover the range with the fewest bins that don't reach outside of it:
+  // going up the levels, a bin at either edge that doesn't pair up with its
+  // neighbour inside the range is merged on its own
+  juce::int64 firstBin = startSample / baseBinSize;
+  juce::int64 endBin = (endSample - 1) / baseBinSize + 1;
+  for (size_t level = 0; level < levels.size() && firstBin < endBin;
+       ++level) {
+    const auto &bins = levels[level];
+    if (firstBin % 2 == 1) {
+      result.merge(bins[static_cast<size_t>(firstBin++)]);
+    }
+    if (endBin % 2 == 1) {
+      result.merge(bins[static_cast<size_t>(--endBin)]);
+    }
+    firstBin /= 2;
+    endBin /= 2;
+  }
+  return result;
+}
+
+WaveformOverview::WaveformOverview()
+    : juce::Thread("Coneko Waveform Overview") {
+  startThread();
+}
+
+WaveformOverview::~WaveformOverview() {
+  signalThreadShouldExit();
+  notify();
+  stopThread(1000);
+}
+
+void WaveformOverview::rebuild(const juce::AudioBuffer<float> &irBuffer) {
+  {
+    const juce::ScopedLock sl(pendingLock);
+    pendingBuffer.makeCopyOf(irBuffer, true);
+    hasPendingBuffer = true;
+  }
+  notify();
+}
+
+std::shared_ptr<const WaveformOverview::Pyramid>
+WaveformOverview::getPyramid() const {
+  const juce::SpinLock::ScopedLockType sl(pyramidLock);
+  return pyramid;
+}
+
+void WaveformOverview::run() {
+  while (!threadShouldExit()) {
+    bool shouldBuild = false;
+    {
+      const juce::ScopedLock sl(pendingLock);
+      if (hasPendingBuffer) {
+        workBuffer.makeCopyOf(pendingBuffer, true);
+        hasPendingBuffer = false;
+        shouldBuild = true;
+      }
+    }
+
+    if (!shouldBuild) {
+      wait(-1);
+      continue;
+    }
+
+    auto newPyramid = build(workBuffer);
+    {
+      const juce::SpinLock::ScopedLockType sl(pyramidLock);
+      pyramid = std::move(newPyramid);
+    }
+    sendChangeMessage();
+  }
+}
+
+std::shared_ptr<const WaveformOverview::Pyramid>
+WaveformOverview::build(const juce::AudioBuffer<float> &irBuffer) {
+  auto newPyramid = std::make_shared<Pyramid>();
+  const int numSamples = irBuffer.getNumSamples();
+  const int numChannels = irBuffer.getNumChannels();
+  newPyramid->numSamples = numSamples;
+  if (numSamples < 1 || numChannels < 1) {
+    return newPyramid;
+  }
+
+  // finest level straight from the samples of all channels
+  const int numBins = (numSamples + baseBinSize - 1) / baseBinSize;
+  std::vector<Bin> bins(numBins);
+  for (int bin = 0; bin < numBins; ++bin) {
+    const int start = bin * baseBinSize;
+    const int size = juce::jmin(baseBinSize, numSamples - start);
+    for (int channel = 0; channel < numChannels; ++channel) {
+      const float *data = irBuffer.getReadPointer(channel, start);
+      auto range = juce::FloatVectorOperations::findMinAndMax(data, size);
+      Bin channelBin;
+      channelBin.min = range.getStart();
+      channelBin.max = range.getEnd();
+      for (int sample = 0; sample < size; ++sample) {
+        channelBin.sumSquares += data[sample] * data[sample];
+      }
+      channelBin.numSamples = size;
+      bins[bin].merge(channelBin);
+    }
+  }
+  newPyramid->levels.push_back(std::move(bins));
+
+  // halve the resolution until a single bin is left
+  while (newPyramid->levels.back().size() > 1) {
+    const auto &finer = newPyramid->levels.back();
+    std::vector<Bin> coarser((finer.size() + 1) / 2);
+    for (size_t bin = 0; bin < finer.size(); ++bin) {
+      coarser[bin / 2].merge(finer[bin]);
+    }
+    newPyramid->levels.push_back(std::move(coarser));
+  }
+  return newPyramid;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <JuceHeader.h>
+
+// Min/max/RMS pyramid of an IR for drawing its waveform. Each level halves
+// the resolution of the one below it, so any sample range can be summarised
+// from a few bins. The pyramid is built on a background thread whenever the
+// IR changes, and published as an immutable snapshot; a change message is
+// sent once it is ready.
+class WaveformOverview : public juce::ChangeBroadcaster, private juce::Thread {
+public:
+  struct Bin {
+    float min = 0.0f;
+    float max = 0.0f;
+    float sumSquares = 0.0f;
+    int numSamples = 0;
+
+    float getPeak() const { return juce::jmax(-min, max); }
+    float getRMS() const;
+    void merge(const Bin &other);
+  };
+
+  class Pyramid {
+  public:
+    int getNumSamples() const { return numSamples; }
+    // summary of samples [startSample, endSample) of all channels. The range
+    // is widened to whole bins of the finest level, i.e. to multiples of
+    // baseBinSize samples
+    Bin getRange(juce::int64 startSample, juce::int64 endSample) const;
+
+  private:
+    friend class WaveformOverview;
+    int numSamples = 0;
+    std::vector<std::vector<Bin>> levels;
+  };
+
+  WaveformOverview();
+  ~WaveformOverview() override;
+
+  // copies the IR and schedules a rebuild of the pyramid
+  void rebuild(const juce::AudioBuffer<float> &irBuffer);
+
+  // latest finished pyramid, or nullptr if no IR has been analysed yet
+  std::shared_ptr<const Pyramid> getPyramid() const;
+
+private:
+  void run() override;
+  static std::shared_ptr<const Pyramid>
+  build(const juce::AudioBuffer<float> &irBuffer);
+
+  // samples summarised by a bin of the finest level
+  static constexpr int baseBinSize = 16;
+
+  juce::CriticalSection pendingLock;
+  juce::AudioBuffer<float> pendingBuffer;
+  bool hasPendingBuffer = false;
+  juce::AudioBuffer<float> workBuffer;
+
+  mutable juce::SpinLock pyramidLock;
+  std::shared_ptr<const Pyramid> pyramid;
+
+  JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR(WaveformOverview)
+};
@@ -37,13 +37,15 @@
 #include <assert.h>
 #include <math.h>
 #include <stdlib.h>
+#include <map>
+#include <mutex>
+#include <vector>
 #include "AAFilter.h"
 #include "FIRFilter.h"
 
 using namespace soundtouch;
 
 #define PI       3.14159265358979323846
-#define TWOPI    (2 * PI)
 
 // define this to save AA filter coefficients to a file
 // #define _DEBUG_SAVE_AAFILTER_COEFFICIENTS   1
@@ -51,7 +53,7 @@ using namespace soundtouch;
 #ifdef _DEBUG_SAVE_AAFILTER_COEFFICIENTS
     #include <stdio.h>
 
-    static void _DEBUG_SAVE_AAFIR_COEFFS(SAMPLETYPE *coeffs, int len)
+    static void _DEBUG_SAVE_AAFIR_COEFFS(const SAMPLETYPE *coeffs, int len)
     {
         FILE *fptr = fopen("aa_filter_coeffs.txt", "wt");
         if (fptr == NULL) return;
@@ -106,15 +108,40 @@ void AAFilter::setLength(uint newLength)
 }
 
 
-// Calculates coefficients for a low-pass FIR filter using Hamming window
-void AAFilter::calculateCoeffs()
+// Zeroth order modified Bessel function of the first kind, needed for Kaiser window
+static double _besselI0(double x)
+{
+    double sum = 1.0;
+    double term = 1.0;
+    double halfX = 0.5 * x;
+
+    // power series converges quickly for the beta values used here
+    for (int k = 1; k < 50; k ++)
+    {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+
+// Designs coefficients for a low-pass FIR filter using Kaiser window. 
+//
+// Compared to a Hamming window, the Kaiser window with AAFILTER_KAISER_BETA 
+// reaches the same stopband rejection with ~12% fewer taps.
+// If the cutoff frequency is exactly quarter of the sampling rate, the result is 
+// a half-band filter where every second coefficient is exactly zero. FIRFilter 
+// detects that and skips the zero coefficients.
+static void _designLowpass(SAMPLETYPE *coeffs, uint length, double cutoffFreq)
 {
     uint i;
-    double cntTemp, temp, tempCoeff,h, w;
+    double cntTemp, temp, h, w, r;
     double wc;
     double scaleCoeff, sum;
+    double beta, i0Beta;
     double *work;
-    SAMPLETYPE *coeffs;
+    bool halfBand;
 
     assert(length >= 2);
     assert(length % 4 == 0);
@@ -122,10 +149,11 @@ void AAFilter::calculateCoeffs()
     assert(cutoffFreq <= 0.5);
 
     work = new double[length];
-    coeffs = new SAMPLETYPE[length];
 
     wc = 2.0 * PI * cutoffFreq;
-    tempCoeff = TWOPI / (double)length;
+    beta = AAFILTER_KAISER_BETA;
+    i0Beta = _besselI0(beta);
+    halfBand = (cutoffFreq == 0.25);
 
     sum = 0;
     for (i = 0; i < length; i ++) 
@@ -141,7 +169,14 @@ void AAFilter::calculateCoeffs()
         {
             h = 1.0;
         }
-        w = 0.54 + 0.46 * cos(tempCoeff * cntTemp);       // hamming window
+        if (halfBand && (cntTemp != 0) && (((int)cntTemp & 1) == 0))
+        {
+            // zero crossings of half-band filter: avoid rounding errors of sin()
+            h = 0;
+        }
+
+        r = cntTemp / (double)(length / 2);
+        w = _besselI0(beta * sqrt(1.0 - r * r)) / i0Beta;   // kaiser window
 
         temp = w * h;
         work[i] = temp;
@@ -165,20 +200,60 @@ void AAFilter::calculateCoeffs()
     for (i = 0; i < length; i ++) 
     {
         temp = work[i] * scaleCoeff;
+#ifdef SOUNDTOUCH_INTEGER_SAMPLES
         // scale & round to nearest integer
         temp += (temp >= 0) ? 0.5 : -0.5;
+#endif
         // ensure no overfloods
         assert(temp >= -32768 && temp <= 32767);
         coeffs[i] = (SAMPLETYPE)temp;
     }
 
+    delete[] work;
+}
+
+
+// Global cache of designed filters, shared by all AAFilter instances. The designs
+// are keyed by filter length and the cutoff frequency quantized to multiples of
+// 0.5 / AAFILTER_CUTOFF_STEPS. Designs are never modified nor removed once created,
+// so that the returned coefficient arrays remain valid for the program lifetime.
+// The quantization also bounds the cache size.
+typedef std::pair<uint, int> _AAFilterKey;
+static std::map<_AAFilterKey, std::vector<SAMPLETYPE> > _designCache;
+static std::mutex _designCacheMutex;
+
+// Returns coefficients of a low-pass filter for given length and cutoff 
+// frequency, designing the filter only if not already found in the cache
+static const SAMPLETYPE *_getDesign(uint length, double cutoffFreq)
+{
+    int step = (int)(cutoffFreq * (2 * AAFILTER_CUTOFF_STEPS) + 0.5);
+    _AAFilterKey key(length, step);
+
+    std::lock_guard<std::mutex> lock(_designCacheMutex);
+
+    std::vector<SAMPLETYPE> &design = _designCache[key];
+    if (design.empty())
+    {
+        design.resize(length);
+        _designLowpass(design.data(), length, (double)step / (2 * AAFILTER_CUTOFF_STEPS));
+    }
+    return design.data();
+}
+
+
+// Sets the FIR coefficients realizing the given cutoff-frequency. The filter
+// design is looked up from the global cache, and as the FIR filter reuses its
+// coefficient arrays when the length doesn't change, changing the cutoff 
+// frequency of an existing filter doesn't allocate memory apart from designing
+// a new cache entry.
+void AAFilter::calculateCoeffs()
+{
+    const SAMPLETYPE *coeffs = _getDesign(length, cutoffFreq);
+
     // Set coefficients. Use divide factor 14 => divide result by 2^14 = 16384
     pFIR->setCoefficients(coeffs, length, 14);
 
     _DEBUG_SAVE_AAFIR_COEFFS(coeffs, length);
-
-    delete[] work;
-    delete[] coeffs;
 }
 
 
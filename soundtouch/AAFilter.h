@@ -43,6 +43,17 @@
 namespace soundtouch
 {
 
+/// Resolution of the cached anti-alias filter designs. The cut-off frequency
+/// is quantized to multiples of 0.5 / AAFILTER_CUTOFF_STEPS.
+#define AAFILTER_CUTOFF_STEPS       4096
+
+/// Kaiser window shape parameter of the anti-alias filter design. Value 5.0 
+/// gives about 53dB stopband rejection.
+#define AAFILTER_KAISER_BETA        5.0
+
+/// Default number of anti-alias filter taps
+#define AAFILTER_DEFAULT_LENGTH     56
+
 class AAFilter
 {
 protected:
@@ -54,7 +65,8 @@ protected:
     /// num of filter taps
     uint length;
 
-    /// Calculate the FIR coefficients realizing the given cutoff-frequency
+    /// Set the FIR coefficients realizing the given cutoff-frequency, using
+    /// shared filter designs cached globally
     void calculateCoeffs();
 public:
     AAFilter(uint length);
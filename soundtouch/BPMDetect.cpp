@@ -57,6 +57,11 @@
 #include "FIFOSampleBuffer.h"
 #include "PeakFinder.h"
 #include "BPMDetect.h"
+#include "cpu_detect.h"
+
+#ifdef SOUNDTOUCH_ALLOW_SSE
+    #include <xmmintrin.h>
+#endif
 
 using namespace soundtouch;
 
@@ -85,6 +90,10 @@ static const double XCORR_DECAY_TIME_CONSTANT = 30.0;
 /// Data overlap factor for beat detection algorithm
 static const int OVERLAP_FACTOR = 4;
 
+/// Number of successive correlation offsets evaluated at a time in the 
+/// autocorrelation loops
+#define XCORR_OFFSET_BLOCK  16
+
 static const double TWOPI = (2 * M_PI);
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -168,6 +177,84 @@ float IIR2_filter::update(float x)
 }
 
 
+// Calculates correlation of 'length' prescaled samples in 'tmp' against 'pBuffer' at 
+// offsets 'offsStart' .. 'offsEnd'-1, and stores the results to 'result[offs]'.
+//
+// Evaluates a block of successive offsets at a time, so that each prescaled sample is
+// reused for the whole block while the block's source samples stay in registers/L1 
+// cache, and so that the compiler can vectorize the loop over the block offsets. The 
+// summation order for each offset is the same as when evaluating the offsets one by one.
+static void _correlate(float *result, const float *tmp, int length, 
+                       const SAMPLETYPE *pBuffer, int offsStart, int offsEnd, bool useSSE)
+{
+    int offs, i, j;
+
+    offs = offsStart;
+
+#ifdef SOUNDTOUCH_ALLOW_SSE
+    if (useSSE)
+    {
+        // SSE version of the block loop below: 16 offsets in four registers
+        for (; offs + XCORR_OFFSET_BLOCK <= offsEnd; offs += XCORR_OFFSET_BLOCK)
+        {
+            const float *ptr = pBuffer + offs;
+            __m128 sum0, sum1, sum2, sum3;
+
+            sum0 = sum1 = sum2 = sum3 = _mm_setzero_ps();
+            for (i = 0; i < length; i ++)
+            {
+                __m128 scaled = _mm_load1_ps(tmp + i);
+                sum0 = _mm_add_ps(sum0, _mm_mul_ps(scaled, _mm_loadu_ps(ptr + i)));
+                sum1 = _mm_add_ps(sum1, _mm_mul_ps(scaled, _mm_loadu_ps(ptr + i + 4)));
+                sum2 = _mm_add_ps(sum2, _mm_mul_ps(scaled, _mm_loadu_ps(ptr + i + 8)));
+                sum3 = _mm_add_ps(sum3, _mm_mul_ps(scaled, _mm_loadu_ps(ptr + i + 12)));
+            }
+            _mm_storeu_ps(result + offs, sum0);
+            _mm_storeu_ps(result + offs + 4, sum1);
+            _mm_storeu_ps(result + offs + 8, sum2);
+            _mm_storeu_ps(result + offs + 12, sum3);
+        }
+    }
+#endif // SOUNDTOUCH_ALLOW_SSE
+
+    for (; offs + XCORR_OFFSET_BLOCK <= offsEnd; offs += XCORR_OFFSET_BLOCK)
+    {
+        const SAMPLETYPE *ptr = pBuffer + offs;
+        float sum[XCORR_OFFSET_BLOCK];
+
+        for (j = 0; j < XCORR_OFFSET_BLOCK; j ++)
+        {
+            sum[j] = 0;
+        }
+
+        for (i = 0; i < length; i ++)
+        {
+            float scaled = tmp[i];
+            for (j = 0; j < XCORR_OFFSET_BLOCK; j ++)
+            {
+                sum[j] += scaled * ptr[i + j];
+            }
+        }
+
+        for (j = 0; j < XCORR_OFFSET_BLOCK; j ++)
+        {
+            result[offs + j] = sum[j];
+        }
+    }
+
+    // remaining offsets one at a time
+    for (; offs < offsEnd; offs ++)
+    {
+        float sum = 0;
+        for (i = 0; i < length; i ++)
+        {
+            sum += tmp[i] * pBuffer[i + offs];
+        }
+        result[offs] = sum;
+    }
+}
+
+
 // IIR low-pass filter coefficients, calculated with matlab/octave cheby2(2,40,0.05)
 const double _LPF_coeffs[5] = { 0.00996655391939, -0.01944529148401, 0.00996655391939, 1.96867605796247, -0.96916387431724 };
 
@@ -208,6 +295,10 @@ BPMDetect::BPMDetect(int numChannels, int aSampleRate) :
     beatcorr_ringbuffpos = 0;
     beatcorr_ringbuff = new float[windowLen];
     memset(beatcorr_ringbuff, 0, windowLen * sizeof(float));
+    corrWork = new float[windowLen];
+
+    // use SSE autocorrelation routine if supported by CPU
+    bUseSSE = (detectCPUextensions() & SUPPORT_SSE) ? true : false;
 
     // allocate processing buffer
     buffer = new FIFOSampleBuffer();
@@ -227,6 +318,7 @@ BPMDetect::~BPMDetect()
 {
     delete[] xcorr;
     delete[] beatcorr_ringbuff;
+    delete[] corrWork;
     delete[] hamw;
     delete[] hamw2;
     delete buffer;
@@ -310,20 +402,14 @@ void BPMDetect::updateXCorr(int process_samples)
         tmp[i] = hamw[i] * hamw[i] * pBuffer[i];
     }
 
-    #pragma omp parallel for
+    // scaling the sub-results shouldn't be necessary
+    _correlate(corrWork, tmp, process_samples, pBuffer, windowStart, windowLen, bUseSSE);
+
     for (offs = windowStart; offs < windowLen; offs ++) 
     {
-        float sum;
-        int i;
-
-        sum = 0;
-        for (i = 0; i < process_samples; i ++) 
-        {
-            sum += tmp[i] * pBuffer[i + offs];  // scaling the sub-result shouldn't be necessary
-        }
         xcorr[offs] *= xcorr_decay;   // decay 'xcorr' here with suitable time constant.
 
-        xcorr[offs] += (float)fabs(sum);
+        xcorr[offs] += (float)fabs(corrWork[offs]);
     }
 }
 
@@ -349,14 +435,11 @@ void BPMDetect::updateBeatPos(int process_samples)
         tmp[i] = hamw2[i] * hamw2[i] * pBuffer[i];
     }
 
-    #pragma omp parallel for
+    _correlate(corrWork, tmp, process_samples, pBuffer, windowStart, windowLen, bUseSSE);
+
     for (int offs = windowStart; offs < windowLen; offs++)
     {
-        float sum = 0;
-        for (int i = 0; i < process_samples; i++)
-        {
-            sum += tmp[i] * pBuffer[offs + i];
-        }
+        float sum = corrWork[offs];
         beatcorr_ringbuff[(beatcorr_ringbuffpos + offs) % windowLen] += (float)((sum > 0) ? sum : 0); // accumulate only positive correlations
     }
 
@@ -127,6 +127,12 @@ namespace soundtouch
         float peakVal;
         float *beatcorr_ringbuff;
 
+        /// Work buffer for the correlation results of an update round
+        float *corrWork;
+
+        /// Use SSE optimized autocorrelation routine
+        bool bUseSSE;
+
         /// FIFO-buffer for decimated processing samples.
         soundtouch::FIFOSampleBuffer *buffer;
 
@@ -54,6 +54,7 @@ FIFOSampleBuffer::FIFOSampleBuffer(int numChannels)
     bufferUnaligned = NULL;
     samplesInBuffer = 0;
     bufferPos = 0;
+    ringMode = false;
     channels = (uint)numChannels;
     ensureCapacity(32);     // allocate initial capacity 
 }
@@ -75,9 +76,69 @@ void FIFOSampleBuffer::setChannels(int numChannels)
 
     if (!verifyNumberOfChannels(numChannels)) return;
 
+    // in ring mode, first move the samples to beginning of the buffer because the
+    // ring capacity in terms of samples changes along with the channel count
+    if (ringMode) rewind();
+
     usedBytes = channels * samplesInBuffer;
     channels = (uint)numChannels;
     samplesInBuffer = usedBytes / channels;
+
+    if (ringMode) mirror(0, samplesInBuffer);
+}
+
+
+// Enables/disables the ring buffer mode. The storage gets reallocated because
+// ring mode requires room for the mirrored copy of the samples. Samples currently
+// in the buffer are preserved.
+void FIFOSampleBuffer::setRingMode(bool enable)
+{
+    uint capacity;
+
+    if (enable == ringMode) return;
+
+    capacity = getCapacity();
+    ringMode = enable;
+    // force reallocation
+    sizeInBytes = 0;
+    ensureCapacity(capacity);
+}
+
+
+// Preallocates the buffer for storing at least 'numSamples' samples
+void FIFOSampleBuffer::reserve(uint numSamples)
+{
+    ensureCapacity(numSamples);
+}
+
+
+// In ring mode, copies the samples at buffer positions 'pos'..'pos + nSamples' 
+// into the other half of the mirrored storage, so that both halves contain the
+// same data and a contiguous view of the samples can begin from any position
+// within the first half.
+void FIFOSampleBuffer::mirror(uint pos, uint nSamples)
+{
+    uint capacity;
+    uint end;
+
+    assert(ringMode);
+
+    capacity = getCapacity();
+    pos %= capacity;
+    end = pos + nSamples;
+    assert(end <= 2 * capacity);
+
+    // samples written into the first half: copy to the second half
+    uint num = ((end < capacity) ? end : capacity) - pos;
+    memcpy(buffer + (pos + capacity) * channels, buffer + pos * channels, 
+           sizeof(SAMPLETYPE) * channels * num);
+
+    if (end > capacity)
+    {
+        // samples written beyond the first half: copy to the beginning of the first half
+        memcpy(buffer, buffer + capacity * channels, 
+               sizeof(SAMPLETYPE) * channels * (end - capacity));
+    }
 }
 
 
@@ -99,6 +160,7 @@ void FIFOSampleBuffer::rewind()
 void FIFOSampleBuffer::putSamples(const SAMPLETYPE *samples, uint nSamples)
 {
     memcpy(ptrEnd(nSamples), samples, sizeof(SAMPLETYPE) * nSamples * channels);
+    if (ringMode) mirror(bufferPos + samplesInBuffer, nSamples);
     samplesInBuffer += nSamples;
 }
 
@@ -115,6 +177,7 @@ void FIFOSampleBuffer::putSamples(uint nSamples)
 
     req = samplesInBuffer + nSamples;
     ensureCapacity(req);
+    if (ringMode) mirror(bufferPos + samplesInBuffer, nSamples);
     samplesInBuffer += nSamples;
 }
 
@@ -131,9 +194,16 @@ void FIFOSampleBuffer::putSamples(uint nSamples)
 // When using this function as means for inserting new samples, also remember 
 // to increase the sample count afterwards, by calling  the 
 // 'putSamples(numSamples)' function.
+//
+// In ring mode the returned location can extend to the mirrored half of the
+// storage; 'putSamples(numSamples)' then copies the new samples to the other half.
 SAMPLETYPE *FIFOSampleBuffer::ptrEnd(uint slackCapacity) 
 {
     ensureCapacity(samplesInBuffer + slackCapacity);
+    if (ringMode)
+    {
+        return buffer + ((bufferPos + samplesInBuffer) % getCapacity()) * channels;
+    }
     return buffer + samplesInBuffer * channels;
 }
 
@@ -156,16 +226,21 @@ SAMPLETYPE *FIFOSampleBuffer::ptrBegin()
 // 'capacityRequirement' number of samples. The buffer is grown in steps of
 // 4 kilobytes to eliminate the need for frequently growing up the buffer,
 // as well as to round the buffer size up to the virtual memory page size.
+//
+// In ring mode the storage is allocated twice as large for the mirrored copy 
+// of the samples, and the buffer is never rewound.
 void FIFOSampleBuffer::ensureCapacity(uint capacityRequirement)
 {
     SAMPLETYPE *tempUnaligned, *temp;
 
     if (capacityRequirement > getCapacity()) 
     {
+        uint numMirrors = ringMode ? 2 : 1;
+
         // enlarge the buffer in 4kbyte steps (round up to next 4k boundary)
         sizeInBytes = (capacityRequirement * channels * sizeof(SAMPLETYPE) + 4095) & (uint)-4096;
         assert(sizeInBytes % 2 == 0);
-        tempUnaligned = new SAMPLETYPE[sizeInBytes / sizeof(SAMPLETYPE) + 16 / sizeof(SAMPLETYPE)];
+        tempUnaligned = new SAMPLETYPE[numMirrors * sizeInBytes / sizeof(SAMPLETYPE) + 16 / sizeof(SAMPLETYPE)];
         if (tempUnaligned == NULL)
         {
             ST_THROW_RT_ERROR("Couldn't allocate memory!\n");
@@ -180,8 +255,9 @@ void FIFOSampleBuffer::ensureCapacity(uint capacityRequirement)
         buffer = temp;
         bufferUnaligned = tempUnaligned;
         bufferPos = 0;
+        if (ringMode) mirror(0, samplesInBuffer);
     } 
-    else 
+    else if (ringMode == false)
     {
         // simply rewind the buffer (if necessary)
         rewind();
@@ -235,6 +311,12 @@ uint FIFOSampleBuffer::receiveSamples(uint maxSamples)
 
     samplesInBuffer -= maxSamples;
     bufferPos += maxSamples;
+    if (ringMode)
+    {
+        // wrap around to the first half of the mirrored storage
+        uint capacity = getCapacity();
+        if (bufferPos >= capacity) bufferPos -= capacity;
+    }
 
     return maxSamples;
 }
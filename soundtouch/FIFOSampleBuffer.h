@@ -73,10 +73,19 @@ private:
     /// only new data when is put to the pipe.
     uint bufferPos;
 
+    /// Ring buffer mode flag. In ring mode the storage holds two mirrored copies of
+    /// the sample data, so that 'bufferPos' can wrap around without ever moving the
+    /// already stored samples, yet 'ptrBegin' still returns a contiguous view.
+    bool ringMode;
+
     /// Rewind the buffer by moving data from position pointed by 'bufferPos' to real 
     /// beginning of the buffer.
     void rewind();
 
+    /// In ring mode, copies 'nSamples' samples starting from buffer position 'pos' 
+    /// to the mirrored half of the ring buffer.
+    void mirror(uint pos, uint nSamples);
+
     /// Ensures that the buffer has capacity for at least this many samples.
     void ensureCapacity(uint capacityRequirement);
 
@@ -161,6 +170,23 @@ public:
         return channels;
     }
 
+    /// Enables/disables the ring buffer mode. In ring mode new samples are written 
+    /// to both halves of a mirrored storage instead of rewinding (i.e. memmoving) 
+    /// the samples remaining in the buffer whenever new samples are put in. This 
+    /// pays off for buffers that keep many samples stored between the batches, 
+    /// such as the input buffer of the time-stretch routine.
+    void setRingMode(bool enable);
+
+    /// Returns true if the ring buffer mode is enabled.
+    bool isRingMode() const
+    {
+        return ringMode;
+    }
+
+    /// Preallocates the buffer for storing at least 'numSamples' samples, so that 
+    /// buffering up to that many samples won't need to allocate memory later.
+    void reserve(uint numSamples);
+
     /// Returns nonzero if there aren't any samples available for outputting.
     virtual int isEmpty() const;
 
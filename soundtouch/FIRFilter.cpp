@@ -59,6 +59,8 @@ FIRFilter::FIRFilter()
     resultDivider = 0;
     length = 0;
     lengthDiv8 = 0;
+    allocatedLength = 0;
+    bHalfBand = false;
     filterCoeffs = NULL;
     filterCoeffsStereo = NULL;
 }
@@ -214,6 +216,47 @@ uint FIRFilter::evaluateFilterMulti(SAMPLETYPE *dest, const SAMPLETYPE *src, uin
 }
 
 
+// C-version of the filter routine for half-band filters with any number of channels.
+// Evaluates only the center tap and the odd taps, as the other coefficients are zero.
+uint FIRFilter::evaluateFilterHalfBand(SAMPLETYPE *dest, const SAMPLETYPE *src, uint numSamples, uint numChannels) const
+{
+    int j, end;
+    int center = (int)(length / 2);
+    int ch = (int)numChannels;
+
+    assert(bHalfBand);
+    assert(length != 0);
+    assert(src != NULL);
+    assert(dest != NULL);
+    assert(filterCoeffs != NULL);
+
+    // with interleaved samples, the outputs of consecutive channels and frames 
+    // are contiguous, thus evaluate all channels in the same loop
+    end = ch * (int)(numSamples - length);
+
+    #pragma omp parallel for
+    for (j = 0; j < end; j ++)
+    {
+        const SAMPLETYPE *ptr = src + j;
+        LONG_SAMPLETYPE sum;
+        int i;
+
+        sum = (LONG_SAMPLETYPE)ptr[center * ch] * filterCoeffs[center];
+        for (i = 1; i < (int)length; i += 2)
+        {
+            sum += ptr[i * ch] * filterCoeffs[i];
+        }
+#ifdef SOUNDTOUCH_INTEGER_SAMPLES
+        sum >>= resultDivFactor;
+        // saturate to 16 bit integer limits
+        sum = (sum < -32768) ? -32768 : (sum > 32767) ? 32767 : sum;
+#endif // SOUNDTOUCH_INTEGER_SAMPLES
+        dest[j] = (SAMPLETYPE)sum;
+    }
+    return numSamples - length;
+}
+
+
 // Set filter coeffiecients and length.
 //
 // Throws an exception if filter length isn't divisible by 8
@@ -222,13 +265,6 @@ void FIRFilter::setCoefficients(const SAMPLETYPE *coeffs, uint newLength, uint u
     assert(newLength > 0);
     if (newLength % 8) ST_THROW_RT_ERROR("FIR filter length not divisible by 8");
 
-    #ifdef SOUNDTOUCH_FLOAT_SAMPLES
-        // scale coefficients already here if using floating samples
-        double scale = 1.0 / resultDivider;
-    #else
-        short scale = 1;
-    #endif
-
     lengthDiv8 = newLength / 8;
     length = lengthDiv8 * 8;
     assert(length == newLength);
@@ -236,10 +272,24 @@ void FIRFilter::setCoefficients(const SAMPLETYPE *coeffs, uint newLength, uint u
     resultDivFactor = uResultDivFactor;
     resultDivider = (SAMPLETYPE)::pow(2.0, (int)resultDivFactor);
 
-    delete[] filterCoeffs;
-    filterCoeffs = new SAMPLETYPE[length];
-    delete[] filterCoeffsStereo;
-    filterCoeffsStereo = new SAMPLETYPE[length*2];
+    #ifdef SOUNDTOUCH_FLOAT_SAMPLES
+        // scale coefficients already here if using floating samples. Notice that
+        // the scale needs to be calculated using the new 'resultDivider' value.
+        double scale = 1.0 / resultDivider;
+    #else
+        short scale = 1;
+    #endif
+
+    // reuse the existing coefficient arrays if the length doesn't change, so that 
+    // updating the filter response doesn't allocate memory
+    if (allocatedLength != length)
+    {
+        delete[] filterCoeffs;
+        filterCoeffs = new SAMPLETYPE[length];
+        delete[] filterCoeffsStereo;
+        filterCoeffsStereo = new SAMPLETYPE[length*2];
+        allocatedLength = length;
+    }
     for (uint i = 0; i < length; i ++)
     {
         filterCoeffs[i] = (SAMPLETYPE)(coeffs[i] * scale);
@@ -248,6 +298,18 @@ void FIRFilter::setCoefficients(const SAMPLETYPE *coeffs, uint newLength, uint u
         filterCoeffsStereo[2 * i] = (SAMPLETYPE)(coeffs[i] * scale);
         filterCoeffsStereo[2 * i + 1] = (SAMPLETYPE)(coeffs[i] * scale);
     }
+
+    // check for half-band filter where coefficients at even distances from the 
+    // center tap are zero
+    bHalfBand = (filterCoeffs[length / 2] != 0);
+    for (uint i = 0; i < length; i += 2)
+    {
+        if ((i != length / 2) && (filterCoeffs[i] != 0))
+        {
+            bHalfBand = false;
+            break;
+        }
+    }
 }
 
 
@@ -268,6 +330,11 @@ uint FIRFilter::evaluate(SAMPLETYPE *dest, const SAMPLETYPE *src, uint numSample
 
     if (numSamples < length) return 0;
 
+    if (bHalfBand)
+    {
+        return evaluateFilterHalfBand(dest, src, numSamples, numChannels);
+    }
+
 #ifndef USE_MULTICH_ALWAYS
     if (numChannels == 1)
     {
@@ -304,6 +371,15 @@ FIRFilter * FIRFilter::newInstance()
 
     // Check if MMX/SSE instruction set extensions supported by CPU
 
+#ifdef SOUNDTOUCH_ALLOW_SSE2
+    // SSE2 integer routines supersede the MMX routines where available
+    if (uExtensions & SUPPORT_SSE2)
+    {
+        return ::new FIRFilterSSE2;
+    }
+    else
+#endif // SOUNDTOUCH_ALLOW_SSE2
+
 #ifdef SOUNDTOUCH_ALLOW_MMX
     // MMX routines available only with integer sample types
     if (uExtensions & SUPPORT_MMX)
@@ -49,6 +49,9 @@ protected:
     // Number of FIR filter taps divided by 8
     uint lengthDiv8;
 
+    // Number of filter taps the coefficient arrays have been allocated for
+    uint allocatedLength;
+
     // Result divider factor in 2^k format
     uint resultDivFactor;
 
@@ -59,6 +62,10 @@ protected:
     SAMPLETYPE *filterCoeffs;
     SAMPLETYPE *filterCoeffsStereo;
 
+    // True if the filter is a half-band filter, i.e. every second coefficient 
+    // apart from the center tap is zero
+    bool bHalfBand;
+
     virtual uint evaluateFilterStereo(SAMPLETYPE *dest, 
                                       const SAMPLETYPE *src, 
                                       uint numSamples) const;
@@ -66,6 +73,7 @@ protected:
                                     const SAMPLETYPE *src, 
                                     uint numSamples) const;
     virtual uint evaluateFilterMulti(SAMPLETYPE *dest, const SAMPLETYPE *src, uint numSamples, uint numChannels);
+    virtual uint evaluateFilterHalfBand(SAMPLETYPE *dest, const SAMPLETYPE *src, uint numSamples, uint numChannels) const;
 
 public:
     FIRFilter();
@@ -117,6 +125,28 @@ public:
 #endif // SOUNDTOUCH_ALLOW_MMX
 
 
+#ifdef SOUNDTOUCH_ALLOW_SSE2
+
+/// Class that implements SSE2 optimized functions exclusive for 16bit integer samples type.
+    class FIRFilterSSE2 : public FIRFilter
+    {
+    protected:
+        short *filterCoeffsUnalign;
+        short *filterCoeffsAlign;
+        short *filterCoeffsMonoAlign;
+
+        virtual uint evaluateFilterStereo(short *dest, const short *src, uint numSamples) const;
+        virtual uint evaluateFilterMono(short *dest, const short *src, uint numSamples) const;
+    public:
+        FIRFilterSSE2();
+        ~FIRFilterSSE2();
+
+        virtual void setCoefficients(const short *coeffs, uint newLength, uint uResultDivFactor);
+    };
+
+#endif // SOUNDTOUCH_ALLOW_SSE2
+
+
 #ifdef SOUNDTOUCH_ALLOW_SSE
     /// Class that implements SSE optimized functions exclusive for floating point samples type.
     class FIRFilterSSE : public FIRFilter
@@ -124,8 +154,13 @@ public:
     protected:
         float *filterCoeffsUnalign;
         float *filterCoeffsAlign;
+        // Each coefficient repeated four times, for evaluating four outputs at a time
+        float *filterCoeffsQuadAlign;
 
         virtual uint evaluateFilterStereo(float *dest, const float *src, uint numSamples) const;
+        virtual uint evaluateFilterMono(float *dest, const float *src, uint numSamples) const;
+        virtual uint evaluateFilterMulti(float *dest, const float *src, uint numSamples, uint numChannels);
+        virtual uint evaluateFilterHalfBand(float *dest, const float *src, uint numSamples, uint numChannels) const;
     public:
         FIRFilterSSE();
         ~FIRFilterSSE();
@@ -93,6 +93,18 @@ public:
     }
 };
 
+
+#ifdef SOUNDTOUCH_ALLOW_SSE
+    /// Class that implements SSE optimized routines for floating point samples type.
+    /// Calculates four output samples at a time.
+    class InterpolateLinearFloatSSE : public InterpolateLinearFloat
+    {
+    protected:
+        int transposeMono(float *dest, const float *src, int &srcSamples);
+        int transposeStereo(float *dest, const float *src, int &srcSamples);
+    };
+#endif // SOUNDTOUCH_ALLOW_SSE
+
 }
 
 #endif
@@ -3,9 +3,12 @@
 /// Sample interpolation routine using 8-tap band-limited Shannon interpolation 
 /// with kaiser window.
 ///
-/// Notice. This algorithm is remarkably much heavier than linear or cubic
-/// interpolation, and not remarkably better than cubic algorithm. Thus mostly
-/// for experimental purposes
+/// The interpolation filter taps are precomputed into a polyphase table for a 
+/// configurable number of fractional phases, optionally interpolating linearly
+/// between the adjacent phases.
+///
+/// Notice. This algorithm is heavier than linear or cubic interpolation, and not 
+/// remarkably better than cubic algorithm. Thus mostly for experimental purposes
 ///
 /// Author        : Copyright (c) Olli Parviainen
 /// Author e-mail : oparviai 'at' iki.fi
@@ -35,6 +38,7 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 #include <math.h>
+#include <assert.h>
 #include "InterpolateShannon.h"
 #include "STTypes.h"
 
@@ -59,6 +63,15 @@ static const double _kaiser8[8] =
 InterpolateShannon::InterpolateShannon()
 {
     fract = 0;
+    pTable = NULL;
+    pTableUnaligned = NULL;
+    setPhases(SHANNON_DEFAULT_PHASES, true);
+}
+
+
+InterpolateShannon::~InterpolateShannon()
+{
+    delete[] pTableUnaligned;
 }
 
 
@@ -71,6 +84,67 @@ void InterpolateShannon::resetRegisters()
 #define PI 3.1415926536
 #define sinc(x) (sin(PI * (x)) / (PI * (x)))
 
+// Sets number of fractional phases in the polyphase filter table, and whether
+// to interpolate linearly between the adjacent phases.
+void InterpolateShannon::setPhases(int phases, bool interpolate)
+{
+    if (phases < 1) ST_THROW_RT_ERROR("Error: Illegal number of interpolation phases");
+
+    numPhases = phases;
+    bInterpolatePhases = interpolate;
+    calcTable();
+}
+
+
+// Calculates the windowed sinc filter taps for fractional positions 0, 1/numPhases, 
+// 2/numPhases, ... 1. The last row is needed for interpolating between the phases
+// at the end of the range.
+void InterpolateShannon::calcTable()
+{
+    delete[] pTableUnaligned;
+    pTableUnaligned = new float[(numPhases + 1) * SHANNON_TAPS + 16 / sizeof(float)];
+    pTable = (float *)SOUNDTOUCH_ALIGN_POINTER_16(pTableUnaligned);
+
+    for (int phase = 0; phase <= numPhases; phase ++)
+    {
+        double pos = (double)phase / (double)numPhases;
+        float *row = pTable + phase * SHANNON_TAPS;
+
+        for (int i = 0; i < SHANNON_TAPS; i ++)
+        {
+            double x = (double)(i - 3) - pos;
+            // sinc(0) = 1
+            row[i] = (float)(((fabs(x) < 1e-6) ? 1.0 : sinc(x)) * _kaiser8[i]);
+        }
+    }
+}
+
+
+// Returns the filter taps for the current 'fract' position
+const float *InterpolateShannon::getTaps(float *work) const
+{
+    double pos = fract * numPhases;
+
+    assert(fract < 1.0);
+
+    if (bInterpolatePhases)
+    {
+        int phase = (int)pos;
+        float f = (float)(pos - phase);
+        const float *row = pTable + phase * SHANNON_TAPS;
+
+        for (int i = 0; i < SHANNON_TAPS; i ++)
+        {
+            work[i] = row[i] + f * (row[i + SHANNON_TAPS] - row[i]);
+        }
+        return work;
+    }
+
+    // use nearest phase
+    return pTable + (int)(pos + 0.5) * SHANNON_TAPS;
+}
+
+
 /// Transpose mono audio. Returns number of produced output samples, and 
 /// updates "srcSamples" to amount of consumed source samples
 int InterpolateShannon::transposeMono(SAMPLETYPE *pdest, 
@@ -84,24 +158,12 @@ int InterpolateShannon::transposeMono(SAMPLETYPE *pdest,
     i = 0;
     while (srcCount < srcSampleEnd)
     {
-        double out;
-        assert(fract < 1.0);
+        float work[SHANNON_TAPS];
+        const float *w = getTaps(work);
+        float out;
 
-        out  = psrc[0] * sinc(-3.0 - fract) * _kaiser8[0];
-        out += psrc[1] * sinc(-2.0 - fract) * _kaiser8[1];
-        out += psrc[2] * sinc(-1.0 - fract) * _kaiser8[2];
-        if (fract < 1e-6)
-        {
-            out += psrc[3] * _kaiser8[3];     // sinc(0) = 1
-        }
-        else
-        {
-            out += psrc[3] * sinc(- fract) * _kaiser8[3];
-        }
-        out += psrc[4] * sinc( 1.0 - fract) * _kaiser8[4];
-        out += psrc[5] * sinc( 2.0 - fract) * _kaiser8[5];
-        out += psrc[6] * sinc( 3.0 - fract) * _kaiser8[6];
-        out += psrc[7] * sinc( 4.0 - fract) * _kaiser8[7];
+        out = psrc[0] * w[0] + psrc[1] * w[1] + psrc[2] * w[2] + psrc[3] * w[3] +
+              psrc[4] * w[4] + psrc[5] * w[5] + psrc[6] * w[6] + psrc[7] * w[7];
 
         pdest[i] = (SAMPLETYPE)out;
         i ++;
@@ -132,25 +194,14 @@ int InterpolateShannon::transposeStereo(SAMPLETYPE *pdest,
     i = 0;
     while (srcCount < srcSampleEnd)
     {
-        double out0, out1, w;
-        assert(fract < 1.0);
-
-        w = sinc(-3.0 - fract) * _kaiser8[0];
-        out0 = psrc[0] * w; out1 = psrc[1] * w;
-        w = sinc(-2.0 - fract) * _kaiser8[1];
-        out0 += psrc[2] * w; out1 += psrc[3] * w;
-        w = sinc(-1.0 - fract) * _kaiser8[2];
-        out0 += psrc[4] * w; out1 += psrc[5] * w;
-        w = _kaiser8[3] * ((fract < 1e-5) ? 1.0 : sinc(- fract));   // sinc(0) = 1
-        out0 += psrc[6] * w; out1 += psrc[7] * w;
-        w = sinc( 1.0 - fract) * _kaiser8[4];
-        out0 += psrc[8] * w; out1 += psrc[9] * w;
-        w = sinc( 2.0 - fract) * _kaiser8[5];
-        out0 += psrc[10] * w; out1 += psrc[11] * w;
-        w = sinc( 3.0 - fract) * _kaiser8[6];
-        out0 += psrc[12] * w; out1 += psrc[13] * w;
-        w = sinc( 4.0 - fract) * _kaiser8[7];
-        out0 += psrc[14] * w; out1 += psrc[15] * w;
+        float work[SHANNON_TAPS];
+        const float *w = getTaps(work);
+        float out0, out1;
+
+        out0 = psrc[0] * w[0] + psrc[2] * w[1] + psrc[4] * w[2] + psrc[6] * w[3] +
+               psrc[8] * w[4] + psrc[10] * w[5] + psrc[12] * w[6] + psrc[14] * w[7];
+        out1 = psrc[1] * w[0] + psrc[3] * w[1] + psrc[5] * w[2] + psrc[7] * w[3] +
+               psrc[9] * w[4] + psrc[11] * w[5] + psrc[13] * w[6] + psrc[15] * w[7];
 
         pdest[2*i]   = (SAMPLETYPE)out0;
         pdest[2*i+1] = (SAMPLETYPE)out1;
@@ -169,13 +220,42 @@ int InterpolateShannon::transposeStereo(SAMPLETYPE *pdest,
 }
 
 
-/// Transpose stereo audio. Returns number of produced output samples, and 
+/// Transpose multi-channel audio. Returns number of produced output samples, and 
 /// updates "srcSamples" to amount of consumed source samples
 int InterpolateShannon::transposeMulti(SAMPLETYPE *pdest, 
                     const SAMPLETYPE *psrc, 
                     int &srcSamples)
 {
-    // not implemented
-    assert(false);
-    return 0;
+    int i;
+    int srcSampleEnd = srcSamples - 8;
+    int srcCount = 0;
+
+    i = 0;
+    while (srcCount < srcSampleEnd)
+    {
+        float work[SHANNON_TAPS];
+        const float *w = getTaps(work);
+
+        for (int c = 0; c < numChannels; c ++)
+        {
+            float out = 0;
+            for (int j = 0; j < SHANNON_TAPS; j ++)
+            {
+                out += psrc[c + j * numChannels] * w[j];
+            }
+            pdest[0] = (SAMPLETYPE)out;
+            pdest ++;
+        }
+        i ++;
+
+        // update position fraction
+        fract += rate;
+        // update whole positions
+        int whole = (int)fract;
+        fract -= whole;
+        psrc += numChannels*whole;
+        srcCount += whole;
+    }
+    srcSamples = srcCount;
+    return i;
 }
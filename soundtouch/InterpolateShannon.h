@@ -3,9 +3,12 @@
 /// Sample interpolation routine using 8-tap band-limited Shannon interpolation 
 /// with kaiser window.
 ///
-/// Notice. This algorithm is remarkably much heavier than linear or cubic
-/// interpolation, and not remarkably better than cubic algorithm. Thus mostly
-/// for experimental purposes
+/// The interpolation filter taps are precomputed into a polyphase table for a 
+/// configurable number of fractional phases, optionally interpolating linearly
+/// between the adjacent phases.
+///
+/// Notice. This algorithm is heavier than linear or cubic interpolation, and not 
+/// remarkably better than cubic algorithm. Thus mostly for experimental purposes
 ///
 /// Author        : Copyright (c) Olli Parviainen
 /// Author e-mail : oparviai 'at' iki.fi
@@ -43,6 +46,12 @@
 namespace soundtouch
 {
 
+/// Default number of fractional phases in the polyphase filter table
+#define SHANNON_DEFAULT_PHASES      256
+
+/// Number of filter taps of the Shannon interpolation
+#define SHANNON_TAPS                8
+
 class InterpolateShannon : public TransposerBase
 {
 protected:
@@ -58,17 +67,52 @@ protected:
 
     double fract;
 
+    /// Number of fractional phases in the filter table
+    int numPhases;
+
+    /// If true, interpolates linearly between two adjacent table phases, 
+    /// otherwise uses the nearest phase
+    bool bInterpolatePhases;
+
+    /// Polyphase filter table of (numPhases + 1) * SHANNON_TAPS coefficients. 
+    /// Aligned to 16 byte boundary for SIMD routines.
+    float *pTable;
+    float *pTableUnaligned;
+
+    /// Calculates the polyphase filter table
+    void calcTable();
+
+    /// Returns the filter taps for the current 'fract' position. Returns pointer 
+    /// either directly to the table or to 'work' array where the taps get interpolated.
+    const float *getTaps(float *work) const;
+
 public:
     InterpolateShannon();
+    virtual ~InterpolateShannon();
 
     void resetRegisters();
 
+    /// Sets number of fractional phases in the polyphase filter table, and whether
+    /// to interpolate linearly between the adjacent phases.
+    void setPhases(int phases, bool interpolate);
+
     int getLatency() const
     {
         return 3;
     }
 };
 
+
+#ifdef SOUNDTOUCH_ALLOW_SSE
+    /// Class that implements SSE optimized routines for floating point samples type.
+    class InterpolateShannonSSE : public InterpolateShannon
+    {
+    protected:
+        int transposeMono(float *dest, const float *src, int &srcSamples);
+        int transposeStereo(float *dest, const float *src, int &srcSamples);
+    };
+#endif // SOUNDTOUCH_ALLOW_SSE
+
 }
 
 #endif
@@ -40,6 +40,7 @@
 #include "InterpolateCubic.h"
 #include "InterpolateShannon.h"
 #include "AAFilter.h"
+#include "cpu_detect.h"
 
 using namespace soundtouch;
 
@@ -59,8 +60,14 @@ RateTransposer::RateTransposer() : FIFOProcessor(&outputBuffer)
 #endif
 
     // Instantiates the anti-alias filter
-    pAAFilter = new AAFilter(64);
+    pAAFilter = new AAFilter(AAFILTER_DEFAULT_LENGTH);
     pTransposer = TransposerBase::newInstance();
+    pTargetBuffer = &outputBuffer;
+
+    // input & mid buffers keep the filter/interpolation history between the batches,
+    // use ring mode to avoid rewinding that history with every new batch
+    inputBuffer.setRingMode(true);
+    midBuffer.setRingMode(true);
     clear();
 }
 
@@ -131,18 +138,24 @@ void RateTransposer::putSamples(const SAMPLETYPE *samples, uint nSamples)
 // the 'set_returnBuffer_size' function.
 void RateTransposer::processSamples(const SAMPLETYPE *src, uint nSamples)
 {
-    uint count;
-
     if (nSamples == 0) return;
 
     // Store samples to input buffer
     inputBuffer.putSamples(src, nSamples);
 
+    processSamples();
+}
+
+
+// Transposes the samples currently in the input buffer, and writes the result to 
+// 'outputBuffer' or the buffer set with 'setOutputBuffer'
+void RateTransposer::processSamples()
+{
     // If anti-alias filter is turned off, simply transpose without applying
     // the filter
     if (bUseAAFilter == false) 
     {
-        count = pTransposer->transpose(outputBuffer, inputBuffer);
+        pTransposer->transpose(*pTargetBuffer, inputBuffer);
         return;
     }
 
@@ -158,7 +171,7 @@ void RateTransposer::processSamples(const SAMPLETYPE *src, uint nSamples)
         pTransposer->transpose(midBuffer, inputBuffer);
 
         // Apply the anti-alias filter for transposed samples in midBuffer
-        pAAFilter->evaluate(outputBuffer, midBuffer);
+        pAAFilter->evaluate(*pTargetBuffer, midBuffer);
     } 
     else  
     {
@@ -170,11 +183,19 @@ void RateTransposer::processSamples(const SAMPLETYPE *src, uint nSamples)
         pAAFilter->evaluate(midBuffer, inputBuffer);
 
         // Transpose the AA-filtered samples in "midBuffer"
-        pTransposer->transpose(outputBuffer, midBuffer);
+        pTransposer->transpose(*pTargetBuffer, midBuffer);
     }
 }
 
 
+// Sets the buffer where the processed samples are written to. NULL restores
+// writing to the own output buffer.
+void RateTransposer::setOutputBuffer(FIFOSampleBuffer *pBuffer)
+{
+    pTargetBuffer = (pBuffer != NULL) ? pBuffer : &outputBuffer;
+}
+
+
 // Sets the number of channels, 1 = mono, 2 = stereo
 void RateTransposer::setChannels(int nChannels)
 {
@@ -299,12 +320,33 @@ TransposerBase *TransposerBase::newInstance()
     switch (algorithm)
     {
         case LINEAR:
+#ifdef SOUNDTOUCH_ALLOW_SSE
+            if (detectCPUextensions() & SUPPORT_SSE)
+            {
+                // SSE support
+                return new InterpolateLinearFloatSSE;
+            }
+#endif // SOUNDTOUCH_ALLOW_SSE
             return new InterpolateLinearFloat;
 
         case CUBIC:
+#ifdef SOUNDTOUCH_ALLOW_SSE
+            if (detectCPUextensions() & SUPPORT_SSE)
+            {
+                // SSE support
+                return new InterpolateCubicSSE;
+            }
+#endif // SOUNDTOUCH_ALLOW_SSE
             return new InterpolateCubic;
 
         case SHANNON:
+#ifdef SOUNDTOUCH_ALLOW_SSE
+            if (detectCPUextensions() & SUPPORT_SSE)
+            {
+                // SSE support
+                return new InterpolateShannonSSE;
+            }
+#endif // SOUNDTOUCH_ALLOW_SSE
             return new InterpolateShannon;
 
         default:
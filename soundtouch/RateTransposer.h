@@ -112,6 +112,10 @@ protected:
     /// Output sample buffer
     FIFOSampleBuffer outputBuffer;
 
+    /// Buffer where the processed samples are written to. Points to 'outputBuffer'
+    /// unless redirected to the input buffer of a next processing stage.
+    FIFOSampleBuffer *pTargetBuffer;
+
     bool bUseAAFilter;
 
 
@@ -129,6 +133,19 @@ public:
     /// Returns the output buffer object
     FIFOSamplePipe *getOutput() { return &outputBuffer; };
 
+    /// Returns the input buffer object
+    FIFOSampleBuffer *getInput() { return &inputBuffer; };
+
+    /// Sets the buffer where the processed samples are written to, or NULL to use the
+    /// object's own output buffer. This allows chaining processing stages so that this
+    /// stage writes its output directly into the input buffer of the next stage,
+    /// which then consumes the samples in place without copying them.
+    void setOutputBuffer(FIFOSampleBuffer *pBuffer);
+
+    /// Transposes the samples currently in the input buffer. Call this after a 
+    /// previous processing stage has written new samples directly into the input buffer.
+    void processSamples();
+
     /// Return anti-alias filter object
     AAFilter *getAAFilter();
 
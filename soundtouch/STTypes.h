@@ -143,6 +143,8 @@ namespace soundtouch
             #if (!_M_X64)
                 #define SOUNDTOUCH_ALLOW_MMX   1
             #endif
+            // Allow SSE2 optimizations, also available in X64 mode
+            #define SOUNDTOUCH_ALLOW_SSE2      1
         #endif
 
     #else
@@ -95,6 +95,10 @@ SoundTouch::SoundTouch()
 
     setOutPipe(pTDStretch);
 
+    // chain the processing stages so that the rate transposer writes its output
+    // directly into the input buffer of the tempo changer
+    pRateTransposer->setOutputBuffer(pTDStretch->getInput());
+
     rate = tempo = 0;
 
     virtualPitch = 
@@ -234,6 +238,10 @@ void SoundTouch::calcEffectiveRateAndTempo()
             FIFOSamplePipe *tempoOut;
 
             assert(output == pRateTransposer);
+            // re-chain the stages: rate transposer writes directly into tempo changer's input
+            pTDStretch->setOutputBuffer(NULL);
+            pRateTransposer->setOutputBuffer(pTDStretch->getInput());
+
             // move samples in the current output buffer to the output of pTDStretch
             tempoOut = pTDStretch->getOutput();
             tempoOut->moveSamples(*output);
@@ -251,6 +259,10 @@ void SoundTouch::calcEffectiveRateAndTempo()
             FIFOSamplePipe *transOut;
 
             assert(output == pTDStretch);
+            // re-chain the stages: tempo changer writes directly into rate transposer's input
+            pRateTransposer->setOutputBuffer(NULL);
+            pTDStretch->setOutputBuffer(pRateTransposer->getInput());
+
             // move samples in the current output buffer to the output of pRateTransposer
             transOut = pRateTransposer->getOutput();
             transOut->moveSamples(*output);
@@ -292,18 +304,20 @@ void SoundTouch::putSamples(const SAMPLETYPE *samples, uint nSamples)
 #ifndef SOUNDTOUCH_PREVENT_CLICK_AT_RATE_CROSSOVER
     if (rate <= 1.0f) 
     {
-        // transpose the rate down, output the transposed sound to tempo changer buffer
+        // transpose the rate down, the transposed sound goes directly to tempo 
+        // changer's input buffer where it gets processed in place
         assert(output == pTDStretch);
         pRateTransposer->putSamples(samples, nSamples);
-        pTDStretch->moveSamples(*pRateTransposer);
+        pTDStretch->processSamples();
     } 
     else 
 #endif
     {
-        // evaluate the tempo changer, then transpose the rate up, 
+        // evaluate the tempo changer, then transpose the rate up. The tempo changer 
+        // output goes directly to rate transposer's input buffer
         assert(output == pRateTransposer);
         pTDStretch->putSamples(samples, nSamples);
-        pRateTransposer->moveSamples(*pTDStretch);
+        pRateTransposer->processSamples();
     }
 }
 
@@ -368,8 +382,26 @@ bool SoundTouch::setSetting(int settingId, int value)
             return true;
 
         case SETTING_USE_QUICKSEEK :
-            // enables / disables tempo routine quick seeking algorithm
-            pTDStretch->enableQuickSeek((value != 0) ? true : false);
+            // selects tempo routine seeking algorithm: full, quick or multi-resolution.
+            // Any other non-zero value selects quick seek, as it always did
+            pTDStretch->enableQuickSeek((value != 0 && value != 2) ? true : false);
+            pTDStretch->enableMultiResolutionSeek((value == 2) ? true : false);
+            return true;
+
+        case SETTING_QUICKSEEK_SCANSTEP :
+            pTDStretch->setQuickSeekParameters(value, -1, -1, -1);
+            return true;
+
+        case SETTING_QUICKSEEK_SCANWINDOW :
+            pTDStretch->setQuickSeekParameters(-1, value, -1, -1);
+            return true;
+
+        case SETTING_QUICKSEEK_CANDIDATES :
+            pTDStretch->setQuickSeekParameters(-1, -1, value, -1);
+            return true;
+
+        case SETTING_MULTIRESSEEK_DECIMATION :
+            pTDStretch->setQuickSeekParameters(-1, -1, -1, value);
             return true;
 
         case SETTING_SEQUENCE_MS:
@@ -410,8 +442,25 @@ int SoundTouch::getSetting(int settingId) const
             return pRateTransposer->getAAFilter()->getLength();
 
         case SETTING_USE_QUICKSEEK :
+            if (pTDStretch->isMultiResolutionSeekEnabled()) return 2;
             return (uint)pTDStretch->isQuickSeekEnabled();
 
+        case SETTING_QUICKSEEK_SCANSTEP :
+            pTDStretch->getQuickSeekParameters(&temp, NULL, NULL, NULL);
+            return temp;
+
+        case SETTING_QUICKSEEK_SCANWINDOW :
+            pTDStretch->getQuickSeekParameters(NULL, &temp, NULL, NULL);
+            return temp;
+
+        case SETTING_QUICKSEEK_CANDIDATES :
+            pTDStretch->getQuickSeekParameters(NULL, NULL, &temp, NULL);
+            return temp;
+
+        case SETTING_MULTIRESSEEK_DECIMATION :
+            pTDStretch->getQuickSeekParameters(NULL, NULL, NULL, &temp);
+            return temp;
+
         case SETTING_SEQUENCE_MS:
             pTDStretch->getParameters(NULL, &temp, NULL, NULL);
             return temp;
@@ -83,12 +83,14 @@ namespace soundtouch
 /// Enable/disable anti-alias filter in pitch transposer (0 = disable)
 #define SETTING_USE_AA_FILTER       0
 
-/// Pitch transposer anti-alias filter length (8 .. 128 taps, default = 32)
+/// Pitch transposer anti-alias filter length (8 .. 128 taps, default = 56)
 #define SETTING_AA_FILTER_LENGTH    1
 
-/// Enable/disable quick seeking algorithm in tempo changer routine
-/// (enabling quick seeking lowers CPU utilization but causes a minor sound
-///  quality compromising)
+/// Select the seeking algorithm in tempo changer routine: 0 = full seek,
+/// 2 = multi-resolution seek, 1 or any other value = quick seek
+/// (quick seeking lowers CPU utilization but causes a minor sound quality 
+///  compromising. Multi-resolution seek scans the whole seek window on decimated
+///  signals and is typically closer to the full seek at similar cost)
 #define SETTING_USE_QUICKSEEK       2
 
 /// Time-stretch algorithm single processing sequence length in milliseconds. This determines 
@@ -165,6 +167,21 @@ namespace soundtouch
 #define SETTING_INITIAL_LATENCY             8
 
 
+/// Quick seek first pass scanning step in samples (default = 16)
+#define SETTING_QUICKSEEK_SCANSTEP          9
+
+/// Quick seek half-width of the refinement window around the best candidates 
+/// in samples (default = 8)
+#define SETTING_QUICKSEEK_SCANWINDOW        10
+
+/// Number of best first pass candidates that the quick and multi-resolution seek
+/// refine (1 .. 8, default = 2)
+#define SETTING_QUICKSEEK_CANDIDATES        11
+
+/// Multi-resolution seek decimation factor of the first pass (default = 4)
+#define SETTING_MULTIRESSEEK_DECIMATION     12
+
+
 class SoundTouch : public FIFOProcessor
 {
 private:
@@ -0,0 +1,170 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// 16bit integer sample variant of the SoundTouch processor.
+///
+/// Compiles the SoundTouch core sources once more with 16bit integer samples,
+/// using 'soundtouch_int16' namespace to keep the classes apart from the
+/// floating point build in the other source files. This file then has to be
+/// the first to include 'STTypes.h' within its compilation unit.
+///
+/// Author        : Copyright (c) Olli Parviainen
+/// Author e-mail : oparviai 'at' iki.fi
+/// SoundTouch WWW: http://www.surina.net/soundtouch
+///
+////////////////////////////////////////////////////////////////////////////////
+//
+// License :
+//
+//  SoundTouch audio processing library
+//  Copyright (c) Olli Parviainen
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifdef SOUNDTOUCH_FLOAT_SAMPLES
+    #error "SoundTouchInt16.cpp must not be compiled with SOUNDTOUCH_FLOAT_SAMPLES"
+#endif
+
+#ifndef SOUNDTOUCH_INTEGER_SAMPLES
+    #define SOUNDTOUCH_INTEGER_SAMPLES      1
+#endif
+
+#define soundtouch soundtouch_int16
+// rename also the global symbols of the core sources
+#define soundtouch_ac_test soundtouch_int16_ac_test
+
+#include "AAFilter.cpp"
+#undef PI
+#include "FIFOSampleBuffer.cpp"
+#include "FIRFilter.cpp"
+#include "InterpolateCubic.cpp"
+#include "InterpolateLinear.cpp"
+#include "InterpolateShannon.cpp"
+#include "RateTransposer.cpp"
+#include "SoundTouch.cpp"
+#include "TDStretch.cpp"
+
+// The optimized routines are compiled here only if enabled, as otherwise these
+// files define a placeholder symbol that is present also in the float build
+#ifdef SOUNDTOUCH_ALLOW_SSE2
+    #include "sse2_optimized.cpp"
+#endif
+#ifdef SOUNDTOUCH_ALLOW_MMX
+    #include "mmx_optimized.cpp"
+#endif
+
+#undef soundtouch
+#undef soundtouch_ac_test
+
+#include "SoundTouchInt16.h"
+
+using namespace soundtouch;
+
+
+SoundTouchInt16::SoundTouchInt16()
+{
+    pSoundTouch = new soundtouch_int16::SoundTouch();
+}
+
+
+SoundTouchInt16::~SoundTouchInt16()
+{
+    delete pSoundTouch;
+}
+
+
+void SoundTouchInt16::setRate(double newRate)
+{
+    pSoundTouch->setRate(newRate);
+}
+
+
+void SoundTouchInt16::setTempo(double newTempo)
+{
+    pSoundTouch->setTempo(newTempo);
+}
+
+
+void SoundTouchInt16::setPitch(double newPitch)
+{
+    pSoundTouch->setPitch(newPitch);
+}
+
+
+void SoundTouchInt16::setPitchSemiTones(double newPitch)
+{
+    pSoundTouch->setPitchSemiTones(newPitch);
+}
+
+
+void SoundTouchInt16::setChannels(uint numChannels)
+{
+    pSoundTouch->setChannels(numChannels);
+}
+
+
+void SoundTouchInt16::setSampleRate(uint srate)
+{
+    pSoundTouch->setSampleRate(srate);
+}
+
+
+void SoundTouchInt16::flush()
+{
+    pSoundTouch->flush();
+}
+
+
+void SoundTouchInt16::putSamples(const short *samples, uint numSamples)
+{
+    pSoundTouch->putSamples(samples, numSamples);
+}
+
+
+uint SoundTouchInt16::receiveSamples(short *output, uint maxSamples)
+{
+    return pSoundTouch->receiveSamples(output, maxSamples);
+}
+
+
+void SoundTouchInt16::clear()
+{
+    pSoundTouch->clear();
+}
+
+
+bool SoundTouchInt16::setSetting(int settingId, int value)
+{
+    return pSoundTouch->setSetting(settingId, value);
+}
+
+
+int SoundTouchInt16::getSetting(int settingId) const
+{
+    return pSoundTouch->getSetting(settingId);
+}
+
+
+uint SoundTouchInt16::numSamples() const
+{
+    return pSoundTouch->numSamples();
+}
+
+
+uint SoundTouchInt16::numUnprocessedSamples() const
+{
+    return pSoundTouch->numUnprocessedSamples();
+}
@@ -0,0 +1,112 @@
+//////////////////////////////////////////////////////////////////////////////
+///
+/// 16bit integer sample variant of the SoundTouch processor, available in the
+/// same binary as the floating point 'SoundTouch' class.
+///
+/// The SoundTouch core selects its sample type at compile time, so the integer
+/// variant is built by compiling the core sources once more with 16bit integer
+/// samples into a separate namespace, see 'SoundTouchInt16.cpp'. This class
+/// exposes that instance with an interface that doesn't depend on the
+/// 'SAMPLETYPE' setting of the including module.
+///
+/// Integer samples take half the memory of floating point samples, which suits
+/// batch-processing large amounts of audio on memory-constrained machines. The
+/// SSE2/MMX routines are chosen according to the CPU when the processor instance
+/// is created.
+///
+/// Author        : Copyright (c) Olli Parviainen
+/// Author e-mail : oparviai 'at' iki.fi
+/// SoundTouch WWW: http://www.surina.net/soundtouch
+///
+////////////////////////////////////////////////////////////////////////////////
+//
+// License :
+//
+//  SoundTouch audio processing library
+//  Copyright (c) Olli Parviainen
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#ifndef SoundTouchInt16_H
+#define SoundTouchInt16_H
+
+#include "STTypes.h"
+
+namespace soundtouch_int16
+{
+    class SoundTouch;
+}
+
+namespace soundtouch
+{
+
+/// SoundTouch processor for 16bit integer samples. See 'SoundTouch' class for
+/// documentation of the member functions.
+class SoundTouchInt16
+{
+private:
+    /// Processor instance compiled with 16bit integer samples
+    soundtouch_int16::SoundTouch *pSoundTouch;
+
+    // Disable copying
+    SoundTouchInt16(const SoundTouchInt16 &);
+    SoundTouchInt16 &operator=(const SoundTouchInt16 &);
+
+public:
+    SoundTouchInt16();
+    ~SoundTouchInt16();
+
+    void setRate(double newRate);
+    void setTempo(double newTempo);
+    void setPitch(double newPitch);
+    void setPitchSemiTones(double newPitch);
+    void setChannels(uint numChannels);
+    void setSampleRate(uint srate);
+
+    /// Flushes the last samples from the processing pipeline to the output.
+    void flush();
+
+    /// Adds 'numSamples' pcs of samples from the 'samples' memory position into
+    /// the input of the object.
+    void putSamples(const short *samples, uint numSamples);
+
+    /// Output samples from beginning of the sample buffer. Copies requested samples to
+    /// output buffer and removes them from the sample buffer.
+    ///
+    /// \return Number of samples returned.
+    uint receiveSamples(short *output, uint maxSamples);
+
+    /// Clears all the samples in the object's output and internal processing
+    /// buffers.
+    void clear();
+
+    /// Changes a setting controlling the processing system behaviour. See the
+    /// 'SETTING_...' defines for available setting ID's.
+    bool setSetting(int settingId, int value);
+
+    /// Reads a setting controlling the processing system behaviour.
+    int getSetting(int settingId) const;
+
+    /// Returns number of samples currently available in the output.
+    uint numSamples() const;
+
+    /// Returns number of samples currently unprocessed.
+    uint numUnprocessedSamples() const;
+};
+
+}
+#endif  // SoundTouchInt16_H
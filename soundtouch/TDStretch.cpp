@@ -83,12 +83,28 @@ const short _scanOffsets[5][24]={
 TDStretch::TDStretch() : FIFOProcessor(&outputBuffer)
 {
     bQuickSeek = false;
+    bMultiResSeek = false;
+    quickSeekScanStep = QUICKSEEK_DEFAULT_SCANSTEP;
+    quickSeekScanWind = QUICKSEEK_DEFAULT_SCANWIND;
+    seekCandidates = QUICKSEEK_DEFAULT_CANDIDATES;
+    seekDecimation = MULTIRESSEEK_DEFAULT_DECIMATION;
     channels = 2;
 
     pMidBuffer = NULL;
     pMidBufferUnaligned = NULL;
+    midBufferCapacity = 0;
+    pCrossfade = NULL;
+    pCrossfadeUnaligned = NULL;
+    crossfadeCapacity = 0;
+    pSeekBuffer = NULL;
+    seekBufferCapacity = 0;
+    pTargetBuffer = &outputBuffer;
     overlapLength = 0;
 
+    // input buffer keeps roughly 'sampleReq' samples stored between the processing
+    // batches, so use ring mode to avoid moving them around whenever new samples arrive
+    inputBuffer.setRingMode(true);
+
     bAutoSeqSetting = true;
     bAutoSeekSetting = true;
 
@@ -104,6 +120,8 @@ TDStretch::TDStretch() : FIFOProcessor(&outputBuffer)
 TDStretch::~TDStretch()
 {
     delete[] pMidBufferUnaligned;
+    delete[] pCrossfadeUnaligned;
+    delete[] pSeekBuffer;
 }
 
 
@@ -155,6 +173,8 @@ void TDStretch::setParameters(int aSampleRate, int aSequenceMS,
 
     calculateOverlapLength(overlapMs);
 
+    preallocateBuffers();
+
     // set tempo to recalculate 'sampleReq'
     setTempo(tempo);
 }
@@ -248,10 +268,74 @@ bool TDStretch::isQuickSeekEnabled() const
 }
 
 
+// Enables/disables the multi-resolution position seeking algorithm
+void TDStretch::enableMultiResolutionSeek(bool enable)
+{
+    bMultiResSeek = enable;
+    if (enable)
+    {
+        preallocateBuffers();
+    }
+}
+
+
+// Returns nonzero if the multi-resolution seeking algorithm is enabled.
+bool TDStretch::isMultiResolutionSeekEnabled() const
+{
+    return bMultiResSeek;
+}
+
+
+// Sets parameters of the quick and multi-resolution seek algorithms. Zero or 
+// negative values keep the current setting.
+void TDStretch::setQuickSeekParameters(int scanStep, int scanWindow, int candidates, int decimation)
+{
+    if (scanStep > 0) quickSeekScanStep = scanStep;
+    if (scanWindow > 0) quickSeekScanWind = scanWindow;
+    if (candidates > 0)
+    {
+        seekCandidates = (candidates > QUICKSEEK_MAX_CANDIDATES) ? QUICKSEEK_MAX_CANDIDATES : candidates;
+    }
+    if (decimation > 0) seekDecimation = decimation;
+
+    // decimation factor affects the seek buffer size
+    preallocateBuffers();
+}
+
+
+// Get quick seek parameters, see setQuickSeekParameters() function.
+void TDStretch::getQuickSeekParameters(int *pScanStep, int *pScanWindow, int *pCandidates, int *pDecimation) const
+{
+    if (pScanStep)
+    {
+        *pScanStep = quickSeekScanStep;
+    }
+
+    if (pScanWindow)
+    {
+        *pScanWindow = quickSeekScanWind;
+    }
+
+    if (pCandidates)
+    {
+        *pCandidates = seekCandidates;
+    }
+
+    if (pDecimation)
+    {
+        *pDecimation = seekDecimation;
+    }
+}
+
+
 // Seeks for the optimal overlap-mixing position.
 int TDStretch::seekBestOverlapPosition(const SAMPLETYPE *refPos)
 {
-    if (bQuickSeek) 
+    if (bMultiResSeek)
+    {
+        return seekBestOverlapPositionMultiRes(refPos);
+    }
+    else if (bQuickSeek) 
     {
         return seekBestOverlapPositionQuick(refPos);
     }
@@ -353,11 +437,32 @@ int TDStretch::seekBestOverlapPositionFull(const SAMPLETYPE *refPos)
 }
 
 
+// Inserts 'offset' with correlation value 'corr' into the list of best candidates
+// that is sorted in descending order of the correlation values, dropping the worst
+// candidate if the list is already full.
+static void _insertCandidate(int *candOffs, float *candCorr, int &numCand, int maxCand, 
+                             int offset, float corr)
+{
+    int i;
+
+    if ((numCand == maxCand) && (corr <= candCorr[numCand - 1])) return;
+    if (numCand < maxCand) numCand ++;
+
+    for (i = numCand - 1; (i > 0) && (corr > candCorr[i - 1]); i --)
+    {
+        candOffs[i] = candOffs[i - 1];
+        candCorr[i] = candCorr[i - 1];
+    }
+    candOffs[i] = offset;
+    candCorr[i] = corr;
+}
+
+
 // Quick seek algorithm for improved runtime-performance: First roughly scans through the 
-// correlation area, and then scan surroundings of two best preliminary correlation candidates
-// with improved precision
+// correlation area with 'quickSeekScanStep' stepping, and then scans surroundings of the
+// 'seekCandidates' best preliminary correlation candidates with improved precision
 //
-// Based on testing:
+// Based on testing with the default parameters (step 16, window 8, two candidates):
 // - This algorithm gives on average 99% as good match as the full algorithm
 // - this quick seek algorithm finds the best match on ~90% of cases
 // - on those 10% of cases when this algorithm doesn't find best match, 
@@ -365,36 +470,32 @@ int TDStretch::seekBestOverlapPositionFull(const SAMPLETYPE *refPos)
 int TDStretch::seekBestOverlapPositionQuick(const SAMPLETYPE *refPos)
 {
 #define _MIN(a, b)   (((a) < (b)) ? (a) : (b))
-#define SCANSTEP    16
-#define SCANWIND    8
 
     int bestOffs;
-    int i;
-    int bestOffs2;
+    int i, c;
+    int numCand;
+    int candOffs[QUICKSEEK_MAX_CANDIDATES];
+    float candCorr[QUICKSEEK_MAX_CANDIDATES];
     float bestCorr, corr;
-    float bestCorr2;
     double norm;
 
     // note: 'float' types used in this function in case that the platform would need to use software-fp
 
-    bestCorr =
-    bestCorr2 = -FLT_MAX;
-    bestOffs = 
-    bestOffs2 = SCANWIND;
+    numCand = 0;
 
     // Scans for the best correlation value by testing each possible position
-    // over the permitted range. Look for two best matches on the first pass to
+    // over the permitted range. Look for several best matches on the first pass to
     // increase possibility of ideal match.
     //
-    // Begin from "SCANSTEP" instead of SCANWIND to make the calculation
+    // Begin from "scan step" instead of scan window to make the calculation
     // catch the 'middlepoint' of seekLength vector as that's the a-priori 
     // expected best match position
     //
-    // Roughly:
+    // Roughly with the default parameters:
     // - 15% of cases find best result directly on the first round,
     // - 75% cases find better match on 2nd round around the best match from 1st round
     // - 10% cases find better match on 2nd round around the 2nd-best-match from 1st round
-    for (i = SCANSTEP; i < seekLength - SCANWIND - 1; i += SCANSTEP)
+    for (i = quickSeekScanStep; i < seekLength - quickSeekScanWind - 1; i += quickSeekScanStep)
     {
         // Calculates correlation value for the mixing position corresponding
         // to 'i'
@@ -403,62 +504,191 @@ int TDStretch::seekBestOverlapPositionQuick(const SAMPLETYPE *refPos)
         float tmp = (float)(2 * i - seekLength - 1) / (float)seekLength;
         corr = ((corr + 0.1f) * (1.0f - 0.25f * tmp * tmp));
 
-        // Checks for the highest correlation value
-        if (corr > bestCorr)
+        _insertCandidate(candOffs, candCorr, numCand, seekCandidates, i, corr);
+    }
+
+    if (numCand == 0)
+    {
+        // seek window too short for the scan step
+        candOffs[0] = _MIN(quickSeekScanWind, seekLength - 1);
+        candCorr[0] = -FLT_MAX;
+        numCand = 1;
+    }
+
+    bestOffs = candOffs[0];
+    bestCorr = candCorr[0];
+
+    // Scans surroundings of the found best matches with small stepping
+    for (c = 0; c < numCand; c ++)
+    {
+        // the scan window may be wider than the scan step, keep the
+        // refinement inside the seek range
+        int begin = max(candOffs[c] - quickSeekScanWind, 0);
+        int end = _MIN(candOffs[c] + quickSeekScanWind + 1, seekLength);
+        for (i = begin; i < end; i++)
         {
-            // found new best match. keep the previous best as 2nd best match
-            bestCorr2 = bestCorr;
-            bestOffs2 = bestOffs;
-            bestCorr = corr;
-            bestOffs = i;
+            if (i == candOffs[c]) continue;    // this offset already calculated, thus skip
+
+            // Calculates correlation value for the mixing position corresponding
+            // to 'i'
+            corr = (float)calcCrossCorr(refPos + channels*i, pMidBuffer, norm);
+            // heuristic rule to slightly favour values close to mid of the range
+            float tmp = (float)(2 * i - seekLength - 1) / (float)seekLength;
+            corr = ((corr + 0.1f) * (1.0f - 0.25f * tmp * tmp));
+
+            // Checks for the highest correlation value
+            if (corr > bestCorr)
+            {
+                bestCorr = corr;
+                bestOffs = i;
+            }
         }
-        else if (corr > bestCorr2)
+    }
+
+    // clear cross correlation routine state if necessary (is so e.g. in MMX routines).
+    clearCrossCorrState();
+
+#ifdef SOUNDTOUCH_INTEGER_SAMPLES
+    adaptNormalizer();
+#endif
+
+    return bestOffs;
+}
+
+
+// Sums groups of 'factor' successive frames of 'src' into 'numOut' frames in 'dest'
+static void _decimate(float *dest, const SAMPLETYPE *src, int numOut, int factor, int channels)
+{
+    int i, j, c;
+
+    for (i = 0; i < numOut; i ++)
+    {
+        for (c = 0; c < channels; c ++)
         {
-            // not new best, but still new 2nd best match
-            bestCorr2 = corr;
-            bestOffs2 = i;
+            float sum = 0;
+            for (j = 0; j < factor; j ++)
+            {
+                sum += (float)src[j * channels + c];
+            }
+            dest[c] = sum;
         }
+        dest += channels;
+        src += factor * channels;
     }
+}
+
 
-    // Scans surroundings of the found best match with small stepping
-    int end = _MIN(bestOffs + SCANWIND + 1, seekLength);
-    for (i = bestOffs - SCANWIND; i < end; i++)
+// Returns the dot product of 'length' values of 'v1' and 'v2'
+static double _dotProduct(const float *v1, const float *v2, int length)
+{
+    float sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+    int i;
+
+    // use separate accumulators so that compiler can vectorize the loop
+    for (i = 0; i < (length & -4); i += 4)
+    {
+        sum0 += v1[i] * v2[i];
+        sum1 += v1[i + 1] * v2[i + 1];
+        sum2 += v1[i + 2] * v2[i + 2];
+        sum3 += v1[i + 3] * v2[i + 3];
+    }
+    for (; i < length; i ++)
     {
-        if (i == bestOffs) continue;    // this offset already calculated, thus skip
+        sum0 += v1[i] * v2[i];
+    }
+    return (double)((sum0 + sum1) + (sum2 + sum3));
+}
 
-        // Calculates correlation value for the mixing position corresponding
-        // to 'i'
-        corr = (float)calcCrossCorr(refPos + channels*i, pMidBuffer, norm);
-        // heuristic rule to slightly favour values close to mid of the range
-        float tmp = (float)(2 * i - seekLength - 1) / (float)seekLength;
-        corr = ((corr + 0.1f) * (1.0f - 0.25f * tmp * tmp));
 
-        // Checks for the highest correlation value
-        if (corr > bestCorr)
+// Multi-resolution seek algorithm: First correlates the signals decimated 
+// by 'seekDecimation' over the whole seek range, then refines the 'seekCandidates' 
+// best local correlation maxima at the full rate within +/- 'seekDecimation' samples.
+//
+// Unlike the quick seek, the coarse pass covers every offset of the seek range, so 
+// that it doesn't miss narrow correlation peaks between the scan steps.
+int TDStretch::seekBestOverlapPositionMultiRes(const SAMPLETYPE *refPos)
+{
+    int decimLength, decimSeek;
+    int bestOffs;
+    int i, c;
+    int numCand;
+    int candOffs[QUICKSEEK_MAX_CANDIDATES];
+    float candCorr[QUICKSEEK_MAX_CANDIDATES];
+    float *pRef, *pMid, *pCorr;
+    float bestCorr, corr;
+    double refNorm, midNorm, norm;
+
+    decimLength = overlapLength / seekDecimation;
+    decimSeek = seekLength / seekDecimation;
+    if ((decimLength < 4) || (decimSeek < 3))
+    {
+        // too short overlap or seek range for decimation
+        return seekBestOverlapPositionFull(refPos);
+    }
+
+    reserveSeekBuffer(seekLength);
+    pCorr = pSeekBuffer;
+    pMid = pCorr + decimSeek;
+    pRef = pMid + channels * decimLength;
+
+    _decimate(pMid, pMidBuffer, decimLength, seekDecimation, channels);
+    _decimate(pRef, refPos, decimSeek + decimLength, seekDecimation, channels);
+
+    // Coarse level: normalized correlation at every decimated offset. Keep the 
+    // reference signal norm updated incrementally over the sliding window.
+    midNorm = _dotProduct(pMid, pMid, channels * decimLength);
+    refNorm = _dotProduct(pRef, pRef, channels * decimLength);
+    for (i = 0; i < decimSeek; i ++)
+    {
+        const float *pRefPos = pRef + channels * i;
+        double denom = sqrt(refNorm * midNorm);
+        double ncorr = (denom < 1e-9) ? 0.0 : _dotProduct(pRefPos, pMid, channels * decimLength) / denom;
+
+        // heuristic rule to slightly favour values close to mid of the seek range
+        float tmp = (float)(2 * i * seekDecimation - seekLength - 1) / (float)seekLength;
+        pCorr[i] = ((float)ncorr + 0.1f) * (1.0f - 0.25f * tmp * tmp);
+
+        for (c = 0; c < channels; c ++)
         {
-            bestCorr = corr;
-            bestOffs = i;
+            float added = pRefPos[channels * decimLength + c];
+            refNorm += added * added - pRefPos[c] * pRefPos[c];
         }
+        if (refNorm < 0) refNorm = 0;
     }
 
-    // Scans surroundings of the 2nd best match with small stepping
-    end = _MIN(bestOffs2 + SCANWIND + 1, seekLength);
-    for (i = bestOffs2 - SCANWIND; i < end; i++)
+    // pick the best local maxima of the coarse correlation as candidates
+    numCand = 0;
+    for (i = 0; i < decimSeek; i ++)
     {
-        if (i == bestOffs2) continue;    // this offset already calculated, thus skip
+        if ((i > 0) && (pCorr[i] < pCorr[i - 1])) continue;
+        if ((i < decimSeek - 1) && (pCorr[i] <= pCorr[i + 1])) continue;
+        _insertCandidate(candOffs, candCorr, numCand, seekCandidates, i * seekDecimation, pCorr[i]);
+    }
+    assert(numCand > 0);
 
-        // Calculates correlation value for the mixing position corresponding
-        // to 'i'
-        corr = (float)calcCrossCorr(refPos + channels*i, pMidBuffer, norm);
-        // heuristic rule to slightly favour values close to mid of the range
-        float tmp = (float)(2 * i - seekLength - 1) / (float)seekLength;
-        corr = ((corr + 0.1f) * (1.0f - 0.25f * tmp * tmp));
+    // Fine level: scan surroundings of the candidates at full rate
+    bestCorr = -FLT_MAX;
+    bestOffs = candOffs[0];
+    for (c = 0; c < numCand; c ++)
+    {
+        int begin = max(candOffs[c] - seekDecimation + 1, 0);
+        int end = _MIN(candOffs[c] + seekDecimation, seekLength);
 
-        // Checks for the highest correlation value
-        if (corr > bestCorr)
+        for (i = begin; i < end; i ++)
         {
-            bestCorr = corr;
-            bestOffs = i;
+            // Calculates correlation value for the mixing position corresponding
+            // to 'i'
+            corr = (float)calcCrossCorr(refPos + channels * i, pMidBuffer, norm);
+            // heuristic rule to slightly favour values close to mid of the range
+            float tmp = (float)(2 * i - seekLength - 1) / (float)seekLength;
+            corr = ((corr + 0.1f) * (1.0f - 0.25f * tmp * tmp));
+
+            // Checks for the highest correlation value
+            if (corr > bestCorr)
+            {
+                bestCorr = corr;
+                bestOffs = i;
+            }
         }
     }
 
@@ -511,42 +741,58 @@ void TDStretch::clearCrossCorrState()
 }
 
 
+// Adjust tempo param according to tempo, so that variating processing sequence length is used
+// at various tempo settings, between the given low...top limits
+#define AUTOSEQ_TEMPO_LOW   0.5     // auto setting low tempo range (-50%)
+#define AUTOSEQ_TEMPO_TOP   2.0     // auto setting top tempo range (+100%)
+
+// sequence-ms setting values at above low & top tempo
+#define AUTOSEQ_AT_MIN      90.0
+#define AUTOSEQ_AT_MAX      40.0
+#define AUTOSEQ_K           ((AUTOSEQ_AT_MAX - AUTOSEQ_AT_MIN) / (AUTOSEQ_TEMPO_TOP - AUTOSEQ_TEMPO_LOW))
+#define AUTOSEQ_C           (AUTOSEQ_AT_MIN - (AUTOSEQ_K) * (AUTOSEQ_TEMPO_LOW))
+
+// seek-window-ms setting values at above low & top tempoq
+#define AUTOSEEK_AT_MIN     20.0
+#define AUTOSEEK_AT_MAX     15.0
+#define AUTOSEEK_K          ((AUTOSEEK_AT_MAX - AUTOSEEK_AT_MIN) / (AUTOSEQ_TEMPO_TOP - AUTOSEQ_TEMPO_LOW))
+#define AUTOSEEK_C          (AUTOSEEK_AT_MIN - (AUTOSEEK_K) * (AUTOSEQ_TEMPO_LOW))
+
+#define CHECK_LIMITS(x, mi, ma) (((x) < (mi)) ? (mi) : (((x) > (ma)) ? (ma) : (x)))
+
+// Automatic sequence and seek window lengths in milliseconds for the given tempo. 
+// The curves are clamped lines, so evaluating them costs less than a table lookup 
+// would; being constexpr, their extremes used for preallocating the buffers are 
+// resolved at compile time.
+static constexpr int _autoSeqMs(double tempo)
+{
+    return (int)(CHECK_LIMITS(AUTOSEQ_C + AUTOSEQ_K * tempo, AUTOSEQ_AT_MAX, AUTOSEQ_AT_MIN) + 0.5);
+}
+
+static constexpr int _autoSeekMs(double tempo)
+{
+    return (int)(CHECK_LIMITS(AUTOSEEK_C + AUTOSEEK_K * tempo, AUTOSEEK_AT_MAX, AUTOSEEK_AT_MIN) + 0.5);
+}
+
+// longest automatic settings occur at the low tempo end
+static constexpr int _autoSeqMaxMs = _autoSeqMs(AUTOSEQ_TEMPO_LOW);
+static constexpr int _autoSeekMaxMs = _autoSeekMs(AUTOSEQ_TEMPO_LOW);
+
+static_assert(_autoSeqMaxMs == (int)AUTOSEQ_AT_MIN, "unexpected auto-sequence curve");
+static_assert(_autoSeekMaxMs == (int)AUTOSEEK_AT_MIN, "unexpected auto-seek curve");
+
+
 /// Calculates processing sequence length according to tempo setting
 void TDStretch::calcSeqParameters()
 {
-    // Adjust tempo param according to tempo, so that variating processing sequence length is used
-    // at various tempo settings, between the given low...top limits
-    #define AUTOSEQ_TEMPO_LOW   0.5     // auto setting low tempo range (-50%)
-    #define AUTOSEQ_TEMPO_TOP   2.0     // auto setting top tempo range (+100%)
-
-    // sequence-ms setting values at above low & top tempo
-    #define AUTOSEQ_AT_MIN      90.0
-    #define AUTOSEQ_AT_MAX      40.0
-    #define AUTOSEQ_K           ((AUTOSEQ_AT_MAX - AUTOSEQ_AT_MIN) / (AUTOSEQ_TEMPO_TOP - AUTOSEQ_TEMPO_LOW))
-    #define AUTOSEQ_C           (AUTOSEQ_AT_MIN - (AUTOSEQ_K) * (AUTOSEQ_TEMPO_LOW))
-
-    // seek-window-ms setting values at above low & top tempoq
-    #define AUTOSEEK_AT_MIN     20.0
-    #define AUTOSEEK_AT_MAX     15.0
-    #define AUTOSEEK_K          ((AUTOSEEK_AT_MAX - AUTOSEEK_AT_MIN) / (AUTOSEQ_TEMPO_TOP - AUTOSEQ_TEMPO_LOW))
-    #define AUTOSEEK_C          (AUTOSEEK_AT_MIN - (AUTOSEEK_K) * (AUTOSEQ_TEMPO_LOW))
-
-    #define CHECK_LIMITS(x, mi, ma) (((x) < (mi)) ? (mi) : (((x) > (ma)) ? (ma) : (x)))
-
-    double seq, seek;
-    
     if (bAutoSeqSetting)
     {
-        seq = AUTOSEQ_C + AUTOSEQ_K * tempo;
-        seq = CHECK_LIMITS(seq, AUTOSEQ_AT_MAX, AUTOSEQ_AT_MIN);
-        sequenceMs = (int)(seq + 0.5);
+        sequenceMs = _autoSeqMs(tempo);
     }
 
     if (bAutoSeekSetting)
     {
-        seek = AUTOSEEK_C + AUTOSEEK_K * tempo;
-        seek = CHECK_LIMITS(seek, AUTOSEEK_AT_MAX, AUTOSEEK_AT_MIN);
-        seekWindowMs = (int)(seek + 0.5);
+        seekWindowMs = _autoSeekMs(tempo);
     }
 
     // Update seek window lengths
@@ -559,6 +805,53 @@ void TDStretch::calcSeqParameters()
 }
 
 
+/// Preallocates the input and output buffers for the worst case buffering need 
+/// with tempo values up to TDSTRETCH_PREALLOC_TEMPO, so that subsequent tempo 
+/// changes don't need to allocate memory. Called when the sample rate, channels
+/// or sequence parameters change.
+void TDStretch::preallocateBuffers()
+{
+    int maxSeqLength, maxSeekLength, maxSkip, maxSampleReq;
+
+    maxSeqLength = (sampleRate * (bAutoSeqSetting ? _autoSeqMaxMs : sequenceMs)) / 1000;
+    if (maxSeqLength < 2 * overlapLength)
+    {
+        maxSeqLength = 2 * overlapLength;
+    }
+    maxSeekLength = (sampleRate * (bAutoSeekSetting ? _autoSeekMaxMs : seekWindowMs)) / 1000;
+
+    // see setTempo() for calculation of 'sampleReq'
+    maxSkip = (int)(TDSTRETCH_PREALLOC_TEMPO * (maxSeqLength - overlapLength) + 0.5);
+    maxSampleReq = max(maxSkip + overlapLength, maxSeqLength) + maxSeekLength;
+
+    // the input buffer holds less than 'sampleReq' unprocessed samples plus a new 
+    // batch; the output buffer receives one sequence per 'nominalSkip' input samples
+    inputBuffer.reserve(2 * maxSampleReq);
+    outputBuffer.reserve(maxSampleReq + maxSeqLength);
+
+    if (bMultiResSeek)
+    {
+        reserveSeekBuffer(maxSeekLength);
+    }
+}
+
+
+/// Ensures that the multi-resolution seek work buffer suffices for seek range of 
+/// 'maxSeekLength' samples with the current overlap length & decimation factor
+void TDStretch::reserveSeekBuffer(int maxSeekLength)
+{
+    // correlation values, decimated reference signal and decimated mid-buffer
+    int required = ((channels + 1) * maxSeekLength + 2 * channels * overlapLength) / seekDecimation + 2;
+
+    if (required > seekBufferCapacity)
+    {
+        delete[] pSeekBuffer;
+        pSeekBuffer = new float[required];
+        seekBufferCapacity = required;
+    }
+}
+
+
 
 // Sets new target tempo. Normal tempo = 'SCALE', smaller values represent slower 
 // tempo, larger faster tempo.
@@ -633,7 +926,7 @@ void TDStretch::processNominalTempo()
 
 
 // Processes as many processing frames of the samples 'inputBuffer', store
-// the result into 'outputBuffer'
+// the result into 'outputBuffer' or the buffer set with 'setOutputBuffer'
 void TDStretch::processSamples()
 {
     int ovlSkip;
@@ -664,8 +957,8 @@ void TDStretch::processSamples()
             // samples in 'midBuffer' using sliding overlapping
             // ... first partially overlap with the end of the previous sequence
             // (that's in 'midBuffer')
-            overlap(outputBuffer.ptrEnd((uint)overlapLength), inputBuffer.ptrBegin(), (uint)offset);
-            outputBuffer.putSamples((uint)overlapLength);
+            overlap(pTargetBuffer->ptrEnd((uint)overlapLength), inputBuffer.ptrBegin(), (uint)offset);
+            pTargetBuffer->putSamples((uint)overlapLength);
             offset += overlapLength;
         }
         else
@@ -703,7 +996,7 @@ void TDStretch::processSamples()
 
         // length of sequence
         temp = (seekWindowLength - 2 * overlapLength);
-        outputBuffer.putSamples(inputBuffer.ptrBegin() + channels * offset, (uint)temp);
+        pTargetBuffer->putSamples(inputBuffer.ptrBegin() + channels * offset, (uint)temp);
 
         // Copies the end of the current sequence from 'inputBuffer' to 
         // 'midBuffer' for being mixed with the beginning of the next 
@@ -735,6 +1028,15 @@ void TDStretch::putSamples(const SAMPLETYPE *samples, uint nSamples)
 
 
 
+// Sets the buffer where the processed samples are written to. NULL restores
+// writing to the own output buffer.
+void TDStretch::setOutputBuffer(FIFOSampleBuffer *pBuffer)
+{
+    pTargetBuffer = (pBuffer != NULL) ? pBuffer : &outputBuffer;
+}
+
+
+
 /// Set new overlap length parameter & reallocate RefMidBuffer if necessary.
 void TDStretch::acceptNewOverlapLength(int newOverlapLength)
 {
@@ -746,14 +1048,51 @@ void TDStretch::acceptNewOverlapLength(int newOverlapLength)
 
     if (overlapLength > prevOvl)
     {
-        delete[] pMidBufferUnaligned;
+        // reallocate only if the current buffer is too small
+        if (overlapLength * channels > midBufferCapacity)
+        {
+            delete[] pMidBufferUnaligned;
 
-        pMidBufferUnaligned = new SAMPLETYPE[overlapLength * channels + 16 / sizeof(SAMPLETYPE)];
-        // ensure that 'pMidBuffer' is aligned to 16 byte boundary for efficiency
-        pMidBuffer = (SAMPLETYPE *)SOUNDTOUCH_ALIGN_POINTER_16(pMidBufferUnaligned);
+            midBufferCapacity = overlapLength * channels;
+            pMidBufferUnaligned = new SAMPLETYPE[midBufferCapacity + 16 / sizeof(SAMPLETYPE)];
+            // ensure that 'pMidBuffer' is aligned to 16 byte boundary for efficiency
+            pMidBuffer = (SAMPLETYPE *)SOUNDTOUCH_ALIGN_POINTER_16(pMidBufferUnaligned);
+        }
 
         clearMidBuffer();
     }
+
+    if (overlapLength != prevOvl)
+    {
+        calcCrossfadeWindow();
+    }
+}
+
+
+/// Calculates the cross-fade window for the current overlap length & channels. The
+/// window is cached, so it needs recalculating only when the overlap length changes.
+void TDStretch::calcCrossfadeWindow()
+{
+    int i, c;
+    float fScale;
+
+    if (overlapLength * channels > crossfadeCapacity)
+    {
+        delete[] pCrossfadeUnaligned;
+
+        crossfadeCapacity = overlapLength * channels;
+        pCrossfadeUnaligned = new float[crossfadeCapacity + 16 / sizeof(float)];
+        pCrossfade = (float *)SOUNDTOUCH_ALIGN_POINTER_16(pCrossfadeUnaligned);
+    }
+
+    fScale = 1.0f / (float)overlapLength;
+    for (i = 0; i < overlapLength; i ++)
+    {
+        for (c = 0; c < channels; c ++)
+        {
+            pCrossfade[i * channels + c] = (float)i * fScale;
+        }
+    }
 }
 
 
@@ -775,6 +1114,15 @@ TDStretch * TDStretch::newInstance()
 
     // Check if MMX/SSE instruction set extensions supported by CPU
 
+#ifdef SOUNDTOUCH_ALLOW_SSE2
+    // SSE2 integer routines supersede the MMX routines where available
+    if (uExtensions & SUPPORT_SSE2)
+    {
+        return ::new TDStretchSSE2;
+    }
+    else
+#endif // SOUNDTOUCH_ALLOW_SSE2
+
 #ifdef SOUNDTOUCH_ALLOW_MMX
     // MMX routines available only with integer sample types
     if (uExtensions & SUPPORT_MMX)
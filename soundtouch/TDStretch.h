@@ -97,6 +97,29 @@ namespace soundtouch
 /// Increasing this value increases computational burden & vice versa.
 #define DEFAULT_OVERLAP_MS      8
 
+/// Buffers are preallocated in setParameters() for tempo values up to this, so that 
+/// changing the tempo doesn't need to allocate memory when processing batches of at 
+/// most 'getInputSampleReq()' samples at a time.
+#define TDSTRETCH_PREALLOC_TEMPO    4.0
+
+/// Default scanning step of the quick seek algorithm, in samples. The first pass of the
+/// quick seek tests every this many offset positions.
+#define QUICKSEEK_DEFAULT_SCANSTEP      16
+
+/// Default half-width of the window, in samples, that the quick seek scans around the 
+/// best candidates of the first pass.
+#define QUICKSEEK_DEFAULT_SCANWIND      8
+
+/// Default number of best candidates of the first pass that the quick seek and 
+/// multi-resolution seek algorithms refine
+#define QUICKSEEK_DEFAULT_CANDIDATES    2
+
+/// Maximum number of candidates, see QUICKSEEK_DEFAULT_CANDIDATES
+#define QUICKSEEK_MAX_CANDIDATES        8
+
+/// Default decimation factor of the coarse level of the multi-resolution seek algorithm
+#define MULTIRESSEEK_DEFAULT_DECIMATION 4
+
 
 /// Class that does the time-stretch (tempo change) effect for the processed
 /// sound.
@@ -125,17 +148,42 @@ protected:
     double skipFract;
 
     bool bQuickSeek;
+    bool bMultiResSeek;
+    int quickSeekScanStep;
+    int quickSeekScanWind;
+    int seekCandidates;
+    int seekDecimation;
     bool bAutoSeqSetting;
     bool bAutoSeekSetting;
     bool isBeginning;
 
     SAMPLETYPE *pMidBuffer;
     SAMPLETYPE *pMidBufferUnaligned;
+    /// Number of samples (over all channels) allocated for 'pMidBuffer'
+    int midBufferCapacity;
+
+    /// Cross-fade window rising from 0 towards 1 over 'overlapLength' samples, with 
+    /// each value repeated for all channels so that the window lines up with the 
+    /// interleaved samples. Aligned to 16 byte boundary. Used by the SIMD overlap 
+    /// routines.
+    float *pCrossfade;
+    float *pCrossfadeUnaligned;
+    int crossfadeCapacity;
+
+    /// Work buffer of the multi-resolution seek for the decimated signals and their 
+    /// correlation values
+    float *pSeekBuffer;
+    int seekBufferCapacity;
 
     FIFOSampleBuffer outputBuffer;
     FIFOSampleBuffer inputBuffer;
 
+    /// Buffer where the processed samples are written to. Points to 'outputBuffer'
+    /// unless redirected to the input buffer of a next processing stage.
+    FIFOSampleBuffer *pTargetBuffer;
+
     void acceptNewOverlapLength(int newOverlapLength);
+    void calcCrossfadeWindow();
 
     virtual void clearCrossCorrState();
     void calculateOverlapLength(int overlapMs);
@@ -145,6 +193,7 @@ protected:
 
     virtual int seekBestOverlapPositionFull(const SAMPLETYPE *refPos);
     virtual int seekBestOverlapPositionQuick(const SAMPLETYPE *refPos);
+    virtual int seekBestOverlapPositionMultiRes(const SAMPLETYPE *refPos);
     virtual int seekBestOverlapPosition(const SAMPLETYPE *refPos);
 
     virtual void overlapStereo(SAMPLETYPE *output, const SAMPLETYPE *input) const;
@@ -155,14 +204,10 @@ protected:
     void overlap(SAMPLETYPE *output, const SAMPLETYPE *input, uint ovlPos) const;
 
     void calcSeqParameters();
+    void preallocateBuffers();
+    void reserveSeekBuffer(int maxSeekLength);
     void adaptNormalizer();
 
-    /// Changes the tempo of the given sound samples.
-    /// Returns amount of samples returned in the "output" buffer.
-    /// The maximum amount of samples that can be returned at a time is set by
-    /// the 'set_returnBuffer_size' function.
-    void processSamples();
-    
 public:
     TDStretch();
     virtual ~TDStretch();
@@ -180,7 +225,18 @@ public:
     FIFOSamplePipe *getOutput() { return &outputBuffer; };
 
     /// Returns the input buffer object
-    FIFOSamplePipe *getInput() { return &inputBuffer; };
+    FIFOSampleBuffer *getInput() { return &inputBuffer; };
+
+    /// Sets the buffer where the processed samples are written to, or NULL to use the
+    /// object's own output buffer. This allows chaining processing stages so that this
+    /// stage writes its output directly into the input buffer of the next stage,
+    /// which then consumes the samples in place without copying them.
+    void setOutputBuffer(FIFOSampleBuffer *pBuffer);
+
+    /// Changes the tempo of the samples currently in the input buffer, and writes
+    /// the result to the output buffer. Call this after a previous processing stage
+    /// has written new samples directly into the input buffer.
+    void processSamples();
 
     /// Sets new target tempo. Normal tempo = 'SCALE', smaller values represent slower 
     /// tempo, larger faster tempo.
@@ -202,6 +258,26 @@ public:
     /// Returns nonzero if the quick seeking algorithm is enabled.
     bool isQuickSeekEnabled() const;
 
+    /// Enables/disables the multi-resolution position seeking algorithm, that first 
+    /// correlates decimated signals over the whole seek window, and then refines the 
+    /// best candidates at the full rate. Overrides the quick seek setting when enabled.
+    void enableMultiResolutionSeek(bool enable);
+
+    /// Returns nonzero if the multi-resolution seeking algorithm is enabled.
+    bool isMultiResolutionSeekEnabled() const;
+
+    /// Sets parameters of the quick and multi-resolution seek algorithms. Zero or 
+    /// negative values keep the current setting.
+    void setQuickSeekParameters(int scanStep,       ///< Quick seek first pass scanning step (samples)
+                                int scanWindow,     ///< Quick seek refinement half-width (samples)
+                                int candidates,     ///< Number of candidates to refine
+                                int decimation      ///< Multi-resolution seek decimation factor
+                                );
+
+    /// Get quick seek parameters, see setQuickSeekParameters() function. Any of the 
+    /// parameters can be NULL, in such case corresponding value isn't returned.
+    void getQuickSeekParameters(int *pScanStep, int *pScanWindow, int *pCandidates, int *pDecimation) const;
+
     /// Sets routine control parameters. These control are certain time constants
     /// defining how the sound is stretched to the desired duration.
     //
@@ -264,6 +340,19 @@ public:
 #endif /// SOUNDTOUCH_ALLOW_MMX
 
 
+#ifdef SOUNDTOUCH_ALLOW_SSE2
+    /// Class that implements SSE2 optimized routines for 16bit integer samples type.
+    class TDStretchSSE2 : public TDStretch
+    {
+    protected:
+        double calcCrossCorr(const short *mixingPos, const short *compare, double &norm);
+        double calcCrossCorrAccumulate(const short *mixingPos, const short *compare, double &norm);
+        virtual void overlapStereo(short *output, const short *input) const;
+        virtual void overlapMono(short *output, const short *input) const;
+    };
+#endif /// SOUNDTOUCH_ALLOW_SSE2
+
+
 #ifdef SOUNDTOUCH_ALLOW_SSE
     /// Class that implements SSE optimized routines for floating point samples type.
     class TDStretchSSE : public TDStretch
@@ -271,6 +360,10 @@ public:
     protected:
         double calcCrossCorr(const float *mixingPos, const float *compare, double &norm);
         double calcCrossCorrAccumulate(const float *mixingPos, const float *compare, double &norm);
+
+        void overlapStereo(float *output, const float *input) const;
+        void overlapMono(float *output, const float *input) const;
+        void overlapMulti(float *output, const float *input) const;
     };
 
 #endif /// SOUNDTOUCH_ALLOW_SSE
@@ -0,0 +1,430 @@
+////////////////////////////////////////////////////////////////////////////////
+///
+/// SSE2 optimized routines for 16bit integer samples type. All SSE2 optimized
+/// integer functions have been gathered into this single source code file,
+/// regardless to their class or original source code file, in order to ease
+/// porting the library to other compiler and processor platforms.
+///
+/// These routines replace the MMX routines of 'mmx_optimized.cpp' that aren't
+/// available in X64 mode. The SSE2-optimizations are programmed using SSE2
+/// compiler intrinsics that are supported both by Microsoft Visual C++ and GCC
+/// compilers, so this file should compile with both toolsets.
+///
+/// Author        : Copyright (c) Olli Parviainen
+/// Author e-mail : oparviai 'at' iki.fi
+/// SoundTouch WWW: http://www.surina.net/soundtouch
+///
+////////////////////////////////////////////////////////////////////////////////
+//
+// License :
+//
+//  SoundTouch audio processing library
+//  Copyright (c) Olli Parviainen
+//
+//  This library is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU Lesser General Public
+//  License as published by the Free Software Foundation; either
+//  version 2.1 of the License, or (at your option) any later version.
+//
+//  This library is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+//  Lesser General Public License for more details.
+//
+//  You should have received a copy of the GNU Lesser General Public
+//  License along with this library; if not, write to the Free Software
+//  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+//
+////////////////////////////////////////////////////////////////////////////////
+
+#include "STTypes.h"
+
+#ifdef SOUNDTOUCH_ALLOW_SSE2
+// SSE2 integer routines available only with integer sample type
+
+using namespace soundtouch;
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// implementation of SSE2 optimized functions of class 'TDStretchSSE2'
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "TDStretch.h"
+#include <emmintrin.h>
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+
+
+// Returns sum of the four 32bit values in 'v'
+static inline long _horizontalSum(__m128i v)
+{
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+    v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+    return (long)_mm_cvtsi128_si32(v);
+}
+
+
+// Calculates cross correlation of two buffers
+double TDStretchSSE2::calcCrossCorr(const short *pV1, const short *pV2, double &dnorm)
+{
+    __m128i shifter;
+    __m128i accu, normaccu;
+    long corr;
+    unsigned long lnorm;
+    int i;
+
+    shifter = _mm_cvtsi32_si128(overlapDividerBitsNorm);
+    normaccu = accu = _mm_setzero_si128();
+
+    // Process 2 parallel sets of 8 samples during each round for improved
+    // CPU-level parallellization. 'pV1' may be unaligned.
+    for (i = 0; i < channels * overlapLength; i += 16)
+    {
+        __m128i vec1a, vec1b, vec2a, vec2b;
+
+        // dictionary of instructions:
+        // _mm_madd_epi16 : 8*16bit multiply-add, resulting four 32bits = [a0*b0+a1*b1 ; ... ; a6*b6+a7*b7]
+        // _mm_add_epi32  : 4*32bit add
+        // _mm_sra_epi32  : 32bit right-shift
+
+        vec1a = _mm_loadu_si128((const __m128i *)(pV1 + i));
+        vec1b = _mm_loadu_si128((const __m128i *)(pV1 + i + 8));
+        vec2a = _mm_loadu_si128((const __m128i *)(pV2 + i));
+        vec2b = _mm_loadu_si128((const __m128i *)(pV2 + i + 8));
+
+        accu = _mm_add_epi32(accu, _mm_add_epi32(_mm_sra_epi32(_mm_madd_epi16(vec1a, vec2a), shifter),
+                                                 _mm_sra_epi32(_mm_madd_epi16(vec1b, vec2b), shifter)));
+        normaccu = _mm_add_epi32(normaccu, _mm_add_epi32(_mm_sra_epi32(_mm_madd_epi16(vec1a, vec1a), shifter),
+                                                         _mm_sra_epi32(_mm_madd_epi16(vec1b, vec1b), shifter)));
+    }
+
+    corr = _horizontalSum(accu);
+    lnorm = (unsigned long)_horizontalSum(normaccu);
+
+    if (lnorm > maxnorm)
+    {
+        // modify 'maxnorm' inside critical section to avoid multi-access conflict if in OpenMP mode
+        #pragma omp critical
+        if (lnorm > maxnorm)
+        {
+            maxnorm = lnorm;
+        }
+    }
+
+    // Normalize result by dividing by sqrt(norm) - this step is easiest
+    // done using floating point operation
+    dnorm = (double)lnorm;
+    return (double)corr / sqrt((dnorm < 1e-9) ? 1.0 : dnorm);
+}
+
+
+/// Update cross-correlation by accumulating "norm" coefficient by previously calculated value
+double TDStretchSSE2::calcCrossCorrAccumulate(const short *pV1, const short *pV2, double &dnorm)
+{
+    __m128i shifter;
+    __m128i accu;
+    long corr, lnorm;
+    int i, ilength;
+
+    // cancel first normalizer tap from previous round
+    lnorm = 0;
+    for (i = 1; i <= channels; i ++)
+    {
+        lnorm -= (pV1[-i] * pV1[-i]) >> overlapDividerBitsNorm;
+    }
+
+    shifter = _mm_cvtsi32_si128(overlapDividerBitsNorm);
+    accu = _mm_setzero_si128();
+
+    ilength = channels * overlapLength;
+    for (i = 0; i < ilength; i += 16)
+    {
+        __m128i temp;
+
+        temp = _mm_add_epi32(_mm_sra_epi32(_mm_madd_epi16(_mm_loadu_si128((const __m128i *)(pV1 + i)),
+                                                          _mm_loadu_si128((const __m128i *)(pV2 + i))), shifter),
+                             _mm_sra_epi32(_mm_madd_epi16(_mm_loadu_si128((const __m128i *)(pV1 + i + 8)),
+                                                          _mm_loadu_si128((const __m128i *)(pV2 + i + 8))), shifter));
+        accu = _mm_add_epi32(accu, temp);
+    }
+
+    corr = _horizontalSum(accu);
+
+    // update normalizer with last samples of this round
+    for (i = 1; i <= channels; i ++)
+    {
+        lnorm += (pV1[ilength - i] * pV1[ilength - i]) >> overlapDividerBitsNorm;
+    }
+
+    dnorm += (double)lnorm;
+    if (dnorm > maxnorm)
+    {
+        maxnorm = (unsigned long)dnorm;
+    }
+
+    // Normalize result by dividing by sqrt(norm) - this step is easiest
+    // done using floating point operation
+    return (double)corr / sqrt((dnorm < 1e-9) ? 1.0 : dnorm);
+}
+
+
+// Cross-fades 'pMid' and 'pInput' that have been interleaved pairwise with
+// _mm_unpack_epi16, so that each 32bit lane holds [mid ; input] sample pair.
+// 'mix' holds the respective [1-k ; k] weights of each pair.
+static inline __m128i _overlapPairs(__m128i pairs, __m128i mix, __m128i shifter)
+{
+    return _mm_sra_epi32(_mm_madd_epi16(pairs, mix), shifter);
+}
+
+
+// SSE2-optimized version of the function overlapMono
+void TDStretchSSE2::overlapMono(short *output, const short *input) const
+{
+    __m128i mix1, mix2, adder, shifter;
+    int i;
+
+    // mix1  = mixer values for samples 0..3
+    // mix2  = mixer values for samples 4..7
+    // adder = adder for updating mixer values after each round
+    mix1  = _mm_set_epi16(3, overlapLength - 3, 2, overlapLength - 2,
+                          1, overlapLength - 1, 0, overlapLength);
+    adder = _mm_set_epi16(4, -4, 4, -4, 4, -4, 4, -4);
+    mix2  = _mm_add_epi16(mix1, adder);
+    adder = _mm_add_epi16(adder, adder);
+
+    // Overlaplength-division by shifter. "+1" is to account for "-1" deduced in
+    // overlapDividerBits calculation earlier.
+    shifter = _mm_cvtsi32_si128(overlapDividerBitsPure + 1);
+
+    for (i = 0; i < overlapLength; i += 8)
+    {
+        __m128i vMid = _mm_load_si128((const __m128i *)(pMidBuffer + i));
+        __m128i vIn = _mm_loadu_si128((const __m128i *)(input + i));
+        __m128i temp1, temp2;
+
+        // pair input & mixbuffer data samples, then (pair .* mix) >> shifter
+        temp1 = _overlapPairs(_mm_unpacklo_epi16(vMid, vIn), mix1, shifter);
+        temp2 = _overlapPairs(_mm_unpackhi_epi16(vMid, vIn), mix2, shifter);
+        _mm_storeu_si128((__m128i *)(output + i), _mm_packs_epi32(temp1, temp2));
+
+        mix1 = _mm_add_epi16(mix1, adder);
+        mix2 = _mm_add_epi16(mix2, adder);
+    }
+}
+
+
+// SSE2-optimized version of the function overlapStereo
+void TDStretchSSE2::overlapStereo(short *output, const short *input) const
+{
+    __m128i mix1, mix2, adder, shifter;
+    int i;
+
+    // mix1  = mixer values for stereo samples 0..1
+    // mix2  = mixer values for stereo samples 2..3
+    // adder = adder for updating mixer values after each round
+    mix1  = _mm_set_epi16(1, overlapLength - 1, 1, overlapLength - 1,
+                          0, overlapLength, 0, overlapLength);
+    adder = _mm_set_epi16(2, -2, 2, -2, 2, -2, 2, -2);
+    mix2  = _mm_add_epi16(mix1, adder);
+    adder = _mm_add_epi16(adder, adder);
+
+    // Overlaplength-division by shifter. "+1" is to account for "-1" deduced in
+    // overlapDividerBits calculation earlier.
+    shifter = _mm_cvtsi32_si128(overlapDividerBitsPure + 1);
+
+    for (i = 0; i < 2 * overlapLength; i += 8)
+    {
+        __m128i vMid = _mm_load_si128((const __m128i *)(pMidBuffer + i));
+        __m128i vIn = _mm_loadu_si128((const __m128i *)(input + i));
+        __m128i temp1, temp2;
+
+        // pair input & mixbuffer data samples, then (pair .* mix) >> shifter
+        temp1 = _overlapPairs(_mm_unpacklo_epi16(vMid, vIn), mix1, shifter);
+        temp2 = _overlapPairs(_mm_unpackhi_epi16(vMid, vIn), mix2, shifter);
+        _mm_storeu_si128((__m128i *)(output + i), _mm_packs_epi32(temp1, temp2));
+
+        mix1 = _mm_add_epi16(mix1, adder);
+        mix2 = _mm_add_epi16(mix2, adder);
+    }
+}
+
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// implementation of SSE2 optimized functions of class 'FIRFilter'
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "FIRFilter.h"
+
+
+FIRFilterSSE2::FIRFilterSSE2() : FIRFilter()
+{
+    filterCoeffsAlign = NULL;
+    filterCoeffsMonoAlign = NULL;
+    filterCoeffsUnalign = NULL;
+}
+
+
+FIRFilterSSE2::~FIRFilterSSE2()
+{
+    delete[] filterCoeffsUnalign;
+    filterCoeffsAlign = NULL;
+    filterCoeffsMonoAlign = NULL;
+    filterCoeffsUnalign = NULL;
+}
+
+
+// (overloaded) Calculates filter coefficients for SSE2 routine
+void FIRFilterSSE2::setCoefficients(const short *coeffs, uint newLength, uint uResultDivFactor)
+{
+    uint i;
+    // check before base class updates 'allocatedLength'
+    bool reallocate = (filterCoeffsUnalign == NULL) || (allocatedLength != newLength);
+
+    FIRFilter::setCoefficients(coeffs, newLength, uResultDivFactor);
+
+    // Ensure that filter coeffs array is aligned to 16-byte boundary. Stereo and
+    // mono coefficient sets share the same allocation. As newLength is divisible
+    // by 8, also the mono set begins at 16-byte boundary.
+    if (reallocate)
+    {
+        delete[] filterCoeffsUnalign;
+        filterCoeffsUnalign = new short[3 * newLength + 8];
+        filterCoeffsAlign = (short *)SOUNDTOUCH_ALIGN_POINTER_16(filterCoeffsUnalign);
+        filterCoeffsMonoAlign = filterCoeffsAlign + 2 * newLength;
+    }
+
+    // rearrange the filter coefficients for the stereo routine, so that
+    // each pair of taps is repeated for left & right channels
+    for (i = 0; i < newLength; i += 4)
+    {
+        filterCoeffsAlign[2 * i + 0] = coeffs[i + 0];
+        filterCoeffsAlign[2 * i + 1] = coeffs[i + 1];
+        filterCoeffsAlign[2 * i + 2] = coeffs[i + 0];
+        filterCoeffsAlign[2 * i + 3] = coeffs[i + 1];
+
+        filterCoeffsAlign[2 * i + 4] = coeffs[i + 2];
+        filterCoeffsAlign[2 * i + 5] = coeffs[i + 3];
+        filterCoeffsAlign[2 * i + 6] = coeffs[i + 2];
+        filterCoeffsAlign[2 * i + 7] = coeffs[i + 3];
+    }
+
+    for (i = 0; i < newLength; i ++)
+    {
+        filterCoeffsMonoAlign[i] = coeffs[i];
+    }
+}
+
+
+// sse2-optimized version of the filter routine for mono sound
+uint FIRFilterSSE2::evaluateFilterMono(short *dest, const short *src, uint numSamples) const
+{
+    int j, end;
+    __m128i shifter;
+    const __m128i *pVfilter = (const __m128i *)filterCoeffsMonoAlign;
+
+    if (length < 2) return 0;
+
+    assert(((ulongptr)filterCoeffsMonoAlign) % 16 == 0);
+
+    shifter = _mm_cvtsi32_si128(resultDivFactor);
+    end = (int)(numSamples - length);
+
+    // Evaluate four outputs at a time
+    for (j = 0; j < (end & -4); j += 4)
+    {
+        const short *pSrc = src + j;
+        __m128i accu0, accu1, accu2, accu3;
+        __m128i temp0, temp1;
+        uint i;
+
+        accu0 = accu1 = accu2 = accu3 = _mm_setzero_si128();
+        for (i = 0; i < length; i += 8)
+        {
+            __m128i vFilter = pVfilter[i / 8];
+
+            accu0 = _mm_add_epi32(accu0, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(pSrc + i)), vFilter));
+            accu1 = _mm_add_epi32(accu1, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(pSrc + i + 1)), vFilter));
+            accu2 = _mm_add_epi32(accu2, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(pSrc + i + 2)), vFilter));
+            accu3 = _mm_add_epi32(accu3, _mm_madd_epi16(_mm_loadu_si128((const __m128i *)(pSrc + i + 3)), vFilter));
+        }
+
+        // transpose & sum so that each 32bit lane holds the sum of one accumulator
+        temp0 = _mm_add_epi32(_mm_unpacklo_epi32(accu0, accu1), _mm_unpackhi_epi32(accu0, accu1));
+        temp1 = _mm_add_epi32(_mm_unpacklo_epi32(accu2, accu3), _mm_unpackhi_epi32(accu2, accu3));
+        temp0 = _mm_add_epi32(_mm_unpacklo_epi64(temp0, temp1), _mm_unpackhi_epi64(temp0, temp1));
+
+        // accu >>= resultDivFactor, then pack & saturate 4*32bits => 4*16 bits
+        temp0 = _mm_sra_epi32(temp0, shifter);
+        _mm_storel_epi64((__m128i *)(dest + j), _mm_packs_epi32(temp0, temp0));
+    }
+
+    // process the remaining outputs with the C routine
+    if (j < end)
+    {
+        FIRFilter::evaluateFilterMono(dest + j, src + j, numSamples - j);
+    }
+
+    return end;
+}
+
+
+// sse2-optimized version of the filter routine for stereo sound
+uint FIRFilterSSE2::evaluateFilterStereo(short *dest, const short *src, uint numSamples) const
+{
+    int j, end;
+    __m128i shifter;
+    const __m128i *pVfilter = (const __m128i *)filterCoeffsAlign;
+
+    if (length < 2) return 0;
+
+    assert(((ulongptr)filterCoeffsAlign) % 16 == 0);
+
+    shifter = _mm_cvtsi32_si128(resultDivFactor);
+    end = 2 * (int)(numSamples - length);
+
+    for (j = 0; j < end; j += 2)
+    {
+        const short *pSrc = src + j;
+        __m128i accu1, accu2;
+        uint i;
+
+        accu1 = accu2 = _mm_setzero_si128();
+        for (i = 0; i < length; i += 8)
+        {
+            __m128i temp1, temp2;
+
+            // shuffle samples as l1 l0 r1 r0 l3 l2 r3 r2, so that multiply-add
+            // yields l1*f1+l0*f0 r1*f1+r0*f0 l3*f3+l2*f2 r3*f3+r2*f2
+            temp1 = _mm_loadu_si128((const __m128i *)(pSrc + 2 * i));
+            temp1 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(temp1, _MM_SHUFFLE(3, 1, 2, 0)), _MM_SHUFFLE(3, 1, 2, 0));
+            temp2 = _mm_loadu_si128((const __m128i *)(pSrc + 2 * i + 8));
+            temp2 = _mm_shufflehi_epi16(_mm_shufflelo_epi16(temp2, _MM_SHUFFLE(3, 1, 2, 0)), _MM_SHUFFLE(3, 1, 2, 0));
+
+            accu1 = _mm_add_epi32(accu1, _mm_madd_epi16(temp1, pVfilter[i / 4]));
+            accu2 = _mm_add_epi32(accu2, _mm_madd_epi16(temp2, pVfilter[i / 4 + 1]));
+        }
+
+        // sum left & right channel lanes: [l ; r ; l ; r] => [l ; r]
+        accu1 = _mm_add_epi32(accu1, accu2);
+        accu1 = _mm_add_epi32(accu1, _mm_shuffle_epi32(accu1, _MM_SHUFFLE(1, 0, 3, 2)));
+
+        // accu >>= resultDivFactor, then pack & saturate 2*32bits => 2*16 bits
+        accu1 = _mm_sra_epi32(accu1, shifter);
+        accu1 = _mm_packs_epi32(accu1, accu1);
+        int packed = _mm_cvtsi128_si32(accu1);
+        memcpy(dest + j, &packed, sizeof(packed));
+    }
+
+    return numSamples - length;
+}
+
+#else
+
+// workaround to not complain about empty module
+bool _dontcomplain_sse2_empty;
+
+#endif  // SOUNDTOUCH_ALLOW_SSE2
@@ -185,6 +185,59 @@ double TDStretchSSE::calcCrossCorrAccumulate(const float *pV1, const float *pV2,
 }
 
 
+// Cross-fades 'numSamples' interleaved samples from 'pMid' to 'pInput' using the 
+// cross-fade window 'pWin' that has the window values repeated for each channel. 
+// Thus the same routine works for any number of channels.
+static void _overlapSSE(float *pOutput, const float *pInput, const float *pMid, 
+                        const float *pWin, int numSamples)
+{
+    int i;
+    const __m128 *pVWin = (const __m128 *)pWin;
+    const __m128 *pVMid = (const __m128 *)pMid;
+
+    assert((numSamples % 8) == 0);
+    assert(((ulongptr)pWin) % 16 == 0);
+    assert(((ulongptr)pMid) % 16 == 0);
+
+    // out = mid + win * (in - mid), i.e. in * win + mid * (1 - win).
+    // Unroll by two for efficiency
+    for (i = 0; i < numSamples / 4; i += 2)
+    {
+        __m128 vMid0 = pVMid[i];
+        __m128 vMid1 = pVMid[i + 1];
+        __m128 vIn0 = _mm_loadu_ps(pInput + 4 * i);
+        __m128 vIn1 = _mm_loadu_ps(pInput + 4 * i + 4);
+
+        _mm_storeu_ps(pOutput + 4 * i,     _mm_add_ps(vMid0, _mm_mul_ps(pVWin[i],     _mm_sub_ps(vIn0, vMid0))));
+        _mm_storeu_ps(pOutput + 4 * i + 4, _mm_add_ps(vMid1, _mm_mul_ps(pVWin[i + 1], _mm_sub_ps(vIn1, vMid1))));
+    }
+}
+
+
+// SSE-optimized version of overlapping mono samples in 'pMidBuffer' with the 
+// samples in 'pInput'
+void TDStretchSSE::overlapMono(float *pOutput, const float *pInput) const
+{
+    _overlapSSE(pOutput, pInput, pMidBuffer, pCrossfade, overlapLength);
+}
+
+
+// SSE-optimized version of overlapping stereo samples in 'pMidBuffer' with the 
+// samples in 'pInput'
+void TDStretchSSE::overlapStereo(float *pOutput, const float *pInput) const
+{
+    _overlapSSE(pOutput, pInput, pMidBuffer, pCrossfade, 2 * overlapLength);
+}
+
+
+// SSE-optimized version of overlapping multichannel samples in 'pMidBuffer' with 
+// the samples in 'pInput'
+void TDStretchSSE::overlapMulti(float *pOutput, const float *pInput) const
+{
+    _overlapSSE(pOutput, pInput, pMidBuffer, pCrossfade, channels * overlapLength);
+}
+
+
 //////////////////////////////////////////////////////////////////////////////
 //
 // implementation of SSE optimized functions of class 'FIRFilter'
@@ -196,6 +249,7 @@ double TDStretchSSE::calcCrossCorrAccumulate(const float *pV1, const float *pV2,
 FIRFilterSSE::FIRFilterSSE() : FIRFilter()
 {
     filterCoeffsAlign = NULL;
+    filterCoeffsQuadAlign = NULL;
     filterCoeffsUnalign = NULL;
 }
 
@@ -204,6 +258,7 @@ FIRFilterSSE::~FIRFilterSSE()
 {
     delete[] filterCoeffsUnalign;
     filterCoeffsAlign = NULL;
+    filterCoeffsQuadAlign = NULL;
     filterCoeffsUnalign = NULL;
 }
 
@@ -213,15 +268,24 @@ void FIRFilterSSE::setCoefficients(const float *coeffs, uint newLength, uint uRe
 {
     uint i;
     float fDivider;
+    // check before base class updates 'allocatedLength'
+    bool reallocate = (filterCoeffsUnalign == NULL) || (allocatedLength != newLength);
 
     FIRFilter::setCoefficients(coeffs, newLength, uResultDivFactor);
 
     // Scale the filter coefficients so that it won't be necessary to scale the filtering result
     // also rearrange coefficients suitably for SSE
     // Ensure that filter coeffs array is aligned to 16-byte boundary
-    delete[] filterCoeffsUnalign;
-    filterCoeffsUnalign = new float[2 * newLength + 4];
-    filterCoeffsAlign = (float *)SOUNDTOUCH_ALIGN_POINTER_16(filterCoeffsUnalign);
+    // Stereo and quad coefficient sets share the same allocation. As newLength is 
+    // divisible by 8, also the quad set begins at 16-byte boundary. Reuse the 
+    // previous allocation if the length doesn't change.
+    if (reallocate)
+    {
+        delete[] filterCoeffsUnalign;
+        filterCoeffsUnalign = new float[6 * newLength + 4];
+        filterCoeffsAlign = (float *)SOUNDTOUCH_ALIGN_POINTER_16(filterCoeffsUnalign);
+        filterCoeffsQuadAlign = filterCoeffsAlign + 2 * newLength;
+    }
 
     fDivider = (float)resultDivider;
 
@@ -230,10 +294,136 @@ void FIRFilterSSE::setCoefficients(const float *coeffs, uint newLength, uint uRe
     {
         filterCoeffsAlign[2 * i + 0] =
         filterCoeffsAlign[2 * i + 1] = coeffs[i + 0] / fDivider;
+
+        filterCoeffsQuadAlign[4 * i + 0] =
+        filterCoeffsQuadAlign[4 * i + 1] =
+        filterCoeffsQuadAlign[4 * i + 2] =
+        filterCoeffsQuadAlign[4 * i + 3] = coeffs[i + 0] / fDivider;
     }
 }
 
 
+// Evaluates FIR filter for 'count' outputs, where the successive filter taps of each 
+// output are 'stride' samples apart in the source data. With interleaved samples 
+// the output values of consecutive channels and frames are then contiguous, so 
+// that the same routine serves both the mono and multichannel cases. 'coeffStep'
+// allows skipping coefficients in the 'coeffsQuad' table, for half-band filters.
+static void _evaluateFilterStrided(float *dest, const float *source, int count, int stride, 
+                                   const float *coeffsQuad, int coeffStep, uint length)
+{
+    int j;
+    int count8 = count & -8;
+
+    assert(((ulongptr)coeffsQuad) % 16 == 0);
+
+    // evaluate eight outputs with each iteration, using two accumulators
+    #pragma omp parallel for
+    for (j = 0; j < count8; j += 8)
+    {
+        const float *pSrc = source + j;
+        const __m128 *pFil = (const __m128*)coeffsQuad;
+        __m128 sum1, sum2;
+        uint i;
+
+        sum1 = sum2 = _mm_setzero_ps();
+
+        for (i = 0; i < length; i ++)
+        {
+            sum1 = _mm_add_ps(sum1, _mm_mul_ps(_mm_loadu_ps(pSrc),     pFil[0]));
+            sum2 = _mm_add_ps(sum2, _mm_mul_ps(_mm_loadu_ps(pSrc + 4), pFil[0]));
+            pSrc += stride;
+            pFil += coeffStep;
+        }
+        _mm_storeu_ps(dest + j, sum1);
+        _mm_storeu_ps(dest + j + 4, sum2);
+    }
+
+    // remaining outputs one at a time
+    for (j = count8; j < count; j ++)
+    {
+        const float *pSrc = source + j;
+        float sum = 0;
+
+        for (uint i = 0; i < length; i ++)
+        {
+            sum += pSrc[0] * coeffsQuad[4 * coeffStep * i];
+            pSrc += stride;
+        }
+        dest[j] = sum;
+    }
+}
+
+
+// SSE-optimized version of the filter routine for mono sound
+uint FIRFilterSSE::evaluateFilterMono(float *dest, const float *source, uint numSamples) const
+{
+    if (numSamples < length) return 0;
+
+    assert(source != NULL);
+    assert(dest != NULL);
+    assert((length % 8) == 0);
+    assert(filterCoeffsQuadAlign != NULL);
+
+    _evaluateFilterStrided(dest, source, (int)(numSamples - length), 1, filterCoeffsQuadAlign, 1, length);
+
+    return numSamples - length;
+}
+
+
+// SSE-optimized version of the filter routine for multichannel sound
+uint FIRFilterSSE::evaluateFilterMulti(float *dest, const float *source, uint numSamples, uint numChannels)
+{
+    if (numSamples < length) return 0;
+
+    assert(source != NULL);
+    assert(dest != NULL);
+    assert((length % 8) == 0);
+    assert(filterCoeffsQuadAlign != NULL);
+
+    _evaluateFilterStrided(dest, source, (int)(numChannels * (numSamples - length)), 
+                           (int)numChannels, filterCoeffsQuadAlign, 1, length);
+
+    return numSamples - length;
+}
+
+
+// SSE-optimized version of the filter routine for half-band filters. Evaluates 
+// only the odd taps and the center tap, as the other coefficients are zero.
+uint FIRFilterSSE::evaluateFilterHalfBand(float *dest, const float *source, uint numSamples, uint numChannels) const
+{
+    int j, count, count4;
+    const float *pCenter;
+    __m128 center;
+
+    assert(bHalfBand);
+    assert(source != NULL);
+    assert(dest != NULL);
+    assert(filterCoeffsQuadAlign != NULL);
+
+    count = (int)(numChannels * (numSamples - length));
+
+    // odd taps 1, 3, 5, ... are 2 frames apart in the source data
+    _evaluateFilterStrided(dest, source + numChannels, count, 2 * (int)numChannels, 
+                           filterCoeffsQuadAlign + 4, 2, length / 2);
+
+    // add the center tap
+    pCenter = source + (length / 2) * numChannels;
+    center = _mm_load_ps(filterCoeffsQuadAlign + 4 * (length / 2));
+    count4 = count & -4;
+    for (j = 0; j < count4; j += 4)
+    {
+        _mm_storeu_ps(dest + j, _mm_add_ps(_mm_loadu_ps(dest + j), 
+                                           _mm_mul_ps(_mm_loadu_ps(pCenter + j), center)));
+    }
+    for (j = count4; j < count; j ++)
+    {
+        dest[j] += pCenter[j] * filterCoeffsQuadAlign[4 * (length / 2)];
+    }
+
+    return numSamples - length;
+}
+
+
 
 // SSE-optimized version of the filter routine for stereo sound
 uint FIRFilterSSE::evaluateFilterStereo(float *dest, const float *source, uint numSamples) const
@@ -362,4 +552,341 @@ uint FIRFilterSSE::evaluateFilterStereo(float *dest, const float *source, uint n
     */
 }
 
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// implementation of SSE optimized functions of class 'InterpolateShannon'
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "InterpolateShannon.h"
+
+// Macro for loading the filter taps of the current 'fract' position into two 
+// SSE registers 'w0' and 'w1', interpolating between the adjacent table phases
+// if enabled
+#define SHANNON_SSE_LOAD_TAPS(w0, w1)                                   \
+    {                                                                   \
+        double pos = fract * numPhases;                                 \
+        const float *row;                                               \
+        if (bInterpolatePhases)                                         \
+        {                                                               \
+            int phase = (int)pos;                                       \
+            __m128 f = _mm_set1_ps((float)(pos - phase));               \
+            row = pTable + phase * SHANNON_TAPS;                        \
+            w0 = _mm_load_ps(row);                                      \
+            w1 = _mm_load_ps(row + 4);                                  \
+            w0 = _mm_add_ps(w0, _mm_mul_ps(f, _mm_sub_ps(_mm_load_ps(row + 8), w0)));   \
+            w1 = _mm_add_ps(w1, _mm_mul_ps(f, _mm_sub_ps(_mm_load_ps(row + 12), w1)));  \
+        }                                                               \
+        else                                                            \
+        {                                                               \
+            row = pTable + (int)(pos + 0.5) * SHANNON_TAPS;             \
+            w0 = _mm_load_ps(row);                                      \
+            w1 = _mm_load_ps(row + 4);                                  \
+        }                                                               \
+    }
+
+
+// SSE-optimized version of the mono interpolation routine
+int InterpolateShannonSSE::transposeMono(float *pdest, const float *psrc, int &srcSamples)
+{
+    int i;
+    int srcSampleEnd = srcSamples - 8;
+    int srcCount = 0;
+
+    assert(((ulongptr)pTable) % 16 == 0);
+
+    i = 0;
+    while (srcCount < srcSampleEnd)
+    {
+        __m128 w0, w1, sum;
+
+        SHANNON_SSE_LOAD_TAPS(w0, w1);
+
+        // source isn't necessarily aligned, use unaligned loads
+        sum = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(psrc), w0), 
+                         _mm_mul_ps(_mm_loadu_ps(psrc + 4), w1));
+
+        // horizontal sum of the four partial sums
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+        sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, _MM_SHUFFLE(1, 1, 1, 1)));
+
+        pdest[i] = _mm_cvtss_f32(sum);
+        i ++;
+
+        // update position fraction
+        fract += rate;
+        // update whole positions
+        int whole = (int)fract;
+        fract -= whole;
+        psrc += whole;
+        srcCount += whole;
+    }
+    srcSamples = srcCount;
+    return i;
+}
+
+
+// SSE-optimized version of the stereo interpolation routine
+int InterpolateShannonSSE::transposeStereo(float *pdest, const float *psrc, int &srcSamples)
+{
+    int i;
+    int srcSampleEnd = srcSamples - 8;
+    int srcCount = 0;
+
+    assert(((ulongptr)pTable) % 16 == 0);
+
+    i = 0;
+    while (srcCount < srcSampleEnd)
+    {
+        __m128 w0, w1, sum;
+
+        SHANNON_SSE_LOAD_TAPS(w0, w1);
+
+        // duplicate the taps for the interleaved left/right samples:
+        // w0 = [t0 t1 t2 t3] => [t0 t0 t1 t1], [t2 t2 t3 t3] etc.
+        sum =                  _mm_mul_ps(_mm_loadu_ps(psrc),      _mm_unpacklo_ps(w0, w0));
+        sum = _mm_add_ps(sum,  _mm_mul_ps(_mm_loadu_ps(psrc + 4),  _mm_unpackhi_ps(w0, w0)));
+        sum = _mm_add_ps(sum,  _mm_mul_ps(_mm_loadu_ps(psrc + 8),  _mm_unpacklo_ps(w1, w1)));
+        sum = _mm_add_ps(sum,  _mm_mul_ps(_mm_loadu_ps(psrc + 12), _mm_unpackhi_ps(w1, w1)));
+
+        // sum = [l0 r0 l1 r1] => [l0+l1 r0+r1 ...]
+        sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+        _mm_storel_pi((__m64 *)(pdest + 2 * i), sum);
+        i ++;
+
+        // update position fraction
+        fract += rate;
+        // update whole positions
+        int whole = (int)fract;
+        fract -= whole;
+        psrc += 2 * whole;
+        srcCount += whole;
+    }
+    srcSamples = srcCount;
+    return i;
+}
+
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// implementation of SSE optimized functions of classes 'InterpolateLinearFloat'
+// and 'InterpolateCubic'
+//
+//////////////////////////////////////////////////////////////////////////////
+
+#include "InterpolateLinear.h"
+#include "InterpolateCubic.h"
+
+// Walks the source position forward by four output samples, storing the whole 
+// source positions to 'pos' and position fractions to 'fr'. The four positions are
+// calculated independently of each other instead of accumulating 'fract' sample by 
+// sample, so that the position arithmetic doesn't form a serial dependency chain.
+// Returns false without modifying 'fract' and 'srcCount' if the source data doesn't 
+// suffice for all four output samples, in which case the remaining samples are left 
+// for the scalar routine.
+static inline bool _getPositions4(double &fract, int &srcCount, double rate, 
+                                  int srcSampleEnd, int *pos, float *fr)
+{
+    for (int k = 0; k < 4; k ++)
+    {
+        double p = fract + k * rate;
+        int whole = (int)p;
+        pos[k] = srcCount + whole;
+        fr[k] = (float)(p - whole);
+    }
+    // positions are monotonic, thus enough to check the last one
+    if (pos[3] >= srcSampleEnd) return false;
+
+    double p = fract + 4 * rate;
+    int whole = (int)p;
+    fract = p - whole;
+    srcCount += whole;
+    return true;
+}
+
+
+// SSE-optimized version of the mono linear interpolation routine
+int InterpolateLinearFloatSSE::transposeMono(float *dest, const float *src, int &srcSamples)
+{
+    int i = 0;
+    int srcSampleEnd = srcSamples - 1;
+    int srcCount = 0;
+    int pos[4];
+    float fr[4];
+
+    while (_getPositions4(fract, srcCount, rate, srcSampleEnd, pos, fr))
+    {
+        __m128 a, b, f;
+
+        a = _mm_set_ps(src[pos[3]],     src[pos[2]],     src[pos[1]],     src[pos[0]]);
+        b = _mm_set_ps(src[pos[3] + 1], src[pos[2] + 1], src[pos[1] + 1], src[pos[0] + 1]);
+        f = _mm_loadu_ps(fr);
+
+        // out = a + fract * (b - a)
+        _mm_storeu_ps(dest + i, _mm_add_ps(a, _mm_mul_ps(f, _mm_sub_ps(b, a))));
+        i += 4;
+    }
+
+    // process the tail with the scalar routine
+    int remaining = srcSamples - srcCount;
+    i += InterpolateLinearFloat::transposeMono(dest + i, src + srcCount, remaining);
+    srcSamples = srcCount + remaining;
+    return i;
+}
+
+
+// SSE-optimized version of the stereo linear interpolation routine
+int InterpolateLinearFloatSSE::transposeStereo(float *dest, const float *src, int &srcSamples)
+{
+    int i = 0;
+    int srcSampleEnd = srcSamples - 1;
+    int srcCount = 0;
+    int pos[4];
+    float fr[4];
+
+    while (_getPositions4(fract, srcCount, rate, srcSampleEnd, pos, fr))
+    {
+        __m128 a01, b01, a23, b23, f, f01, f23;
+
+        // a01 = [l(p0) r(p0) l(p1) r(p1)], b01 = same for the next source samples
+        a01 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(src + 2 * pos[0])), 
+                                                          (const __m64 *)(src + 2 * pos[1]));
+        b01 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(src + 2 * pos[0] + 2)), 
+                                                          (const __m64 *)(src + 2 * pos[1] + 2));
+        a23 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(src + 2 * pos[2])), 
+                                                          (const __m64 *)(src + 2 * pos[3]));
+        b23 = _mm_loadh_pi(_mm_loadl_pi(_mm_setzero_ps(), (const __m64 *)(src + 2 * pos[2] + 2)), 
+                                                          (const __m64 *)(src + 2 * pos[3] + 2));
+
+        // f01 = [f0 f0 f1 f1], f23 = [f2 f2 f3 f3]
+        f = _mm_loadu_ps(fr);
+        f01 = _mm_unpacklo_ps(f, f);
+        f23 = _mm_unpackhi_ps(f, f);
+
+        _mm_storeu_ps(dest + 2 * i,     _mm_add_ps(a01, _mm_mul_ps(f01, _mm_sub_ps(b01, a01))));
+        _mm_storeu_ps(dest + 2 * i + 4, _mm_add_ps(a23, _mm_mul_ps(f23, _mm_sub_ps(b23, a23))));
+        i += 4;
+    }
+
+    // process the tail with the scalar routine
+    int remaining = srcSamples - srcCount;
+    i += InterpolateLinearFloat::transposeStereo(dest + 2 * i, src + 2 * srcCount, remaining);
+    srcSamples = srcCount + remaining;
+    return i;
+}
+
+
+// Calculates the cubic interpolation weights y0..y3 for four position fractions 
+// at a time. See '_coeffs' in InterpolateCubic.cpp.
+static inline void _cubicWeights4(const float *fr, __m128 &y0, __m128 &y1, __m128 &y2, __m128 &y3)
+{
+    const __m128 x  = _mm_loadu_ps(fr);            // x
+    const __m128 xx = _mm_mul_ps(x, x);            // x^2
+    const __m128 xxx = _mm_mul_ps(xx, x);          // x^3
+
+    // y0 = -0.5 x^3 + 1.0 x^2 - 0.5 x
+    y0 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(-0.5f), xxx), xx), 
+                    _mm_mul_ps(_mm_set1_ps(-0.5f), x));
+    // y1 = 1.5 x^3 - 2.5 x^2 + 1
+    y1 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(1.5f), xxx), 
+                               _mm_mul_ps(_mm_set1_ps(-2.5f), xx)), _mm_set1_ps(1.0f));
+    // y2 = -1.5 x^3 + 2.0 x^2 + 0.5 x
+    y2 = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(-1.5f), xxx), 
+                               _mm_mul_ps(_mm_set1_ps(2.0f), xx)), _mm_mul_ps(_mm_set1_ps(0.5f), x));
+    // y3 = 0.5 x^3 - 0.5 x^2
+    y3 = _mm_mul_ps(_mm_set1_ps(0.5f), _mm_sub_ps(xxx, xx));
+}
+
+
+// SSE-optimized version of the mono cubic interpolation routine
+int InterpolateCubicSSE::transposeMono(float *pdest, const float *psrc, int &srcSamples)
+{
+    int i = 0;
+    int srcSampleEnd = srcSamples - 4;
+    int srcCount = 0;
+    int pos[4];
+    float fr[4];
+
+    while (_getPositions4(fract, srcCount, rate, srcSampleEnd, pos, fr))
+    {
+        __m128 y0, y1, y2, y3;
+        __m128 s0, s1, s2, s3;
+
+        _cubicWeights4(fr, y0, y1, y2, y3);
+
+        // load four source samples for each output, then transpose so that 
+        // s0 = first samples of each output position, s1 = second samples etc.
+        s0 = _mm_loadu_ps(psrc + pos[0]);
+        s1 = _mm_loadu_ps(psrc + pos[1]);
+        s2 = _mm_loadu_ps(psrc + pos[2]);
+        s3 = _mm_loadu_ps(psrc + pos[3]);
+        _MM_TRANSPOSE4_PS(s0, s1, s2, s3);
+
+        _mm_storeu_ps(pdest + i, _mm_add_ps(_mm_add_ps(_mm_mul_ps(y0, s0), _mm_mul_ps(y1, s1)),
+                                            _mm_add_ps(_mm_mul_ps(y2, s2), _mm_mul_ps(y3, s3))));
+        i += 4;
+    }
+
+    // process the tail with the scalar routine
+    int remaining = srcSamples - srcCount;
+    i += InterpolateCubic::transposeMono(pdest + i, psrc + srcCount, remaining);
+    srcSamples = srcCount + remaining;
+    return i;
+}
+
+
+// SSE-optimized version of the stereo cubic interpolation routine
+int InterpolateCubicSSE::transposeStereo(float *pdest, const float *psrc, int &srcSamples)
+{
+    int i = 0;
+    int srcSampleEnd = srcSamples - 4;
+    int srcCount = 0;
+    int pos[4];
+    float fr[4];
+
+    while (_getPositions4(fract, srcCount, rate, srcSampleEnd, pos, fr))
+    {
+        __m128 y0, y1, y2, y3;
+        __m128 l0, l1, l2, l3;
+        __m128 r0, r1, r2, r3;
+        __m128 outl, outr;
+
+        _cubicWeights4(fr, y0, y1, y2, y3);
+
+        // deinterleave four stereo source samples of each output position
+        #define DEINTERLEAVE_CUBIC(l, r, p)                                 \
+        {                                                                   \
+            __m128 lo = _mm_loadu_ps(psrc + 2 * (p));                       \
+            __m128 hi = _mm_loadu_ps(psrc + 2 * (p) + 4);                   \
+            l = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(2, 0, 2, 0));            \
+            r = _mm_shuffle_ps(lo, hi, _MM_SHUFFLE(3, 1, 3, 1));            \
+        }
+        DEINTERLEAVE_CUBIC(l0, r0, pos[0]);
+        DEINTERLEAVE_CUBIC(l1, r1, pos[1]);
+        DEINTERLEAVE_CUBIC(l2, r2, pos[2]);
+        DEINTERLEAVE_CUBIC(l3, r3, pos[3]);
+        #undef DEINTERLEAVE_CUBIC
+
+        _MM_TRANSPOSE4_PS(l0, l1, l2, l3);
+        _MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+
+        outl = _mm_add_ps(_mm_add_ps(_mm_mul_ps(y0, l0), _mm_mul_ps(y1, l1)),
+                          _mm_add_ps(_mm_mul_ps(y2, l2), _mm_mul_ps(y3, l3)));
+        outr = _mm_add_ps(_mm_add_ps(_mm_mul_ps(y0, r0), _mm_mul_ps(y1, r1)),
+                          _mm_add_ps(_mm_mul_ps(y2, r2), _mm_mul_ps(y3, r3)));
+
+        // interleave back to stereo
+        _mm_storeu_ps(pdest + 2 * i,     _mm_unpacklo_ps(outl, outr));
+        _mm_storeu_ps(pdest + 2 * i + 4, _mm_unpackhi_ps(outl, outr));
+        i += 4;
+    }
+
+    // process the tail with the scalar routine
+    int remaining = srcSamples - srcCount;
+    i += InterpolateCubic::transposeStereo(pdest + 2 * i, psrc + 2 * srcCount, remaining);
+    srcSamples = srcCount + remaining;
+    return i;
+}
+
 #endif  // SOUNDTOUCH_ALLOW_SSE